@@ -0,0 +1,114 @@
+//
+//  compile_benchmark.cc
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "takram/algorithm/leaf_iterator_iterator.h"
+#include "takram/algorithm/tuple_iterator_iterator.h"
+
+// Instantiates TupleIteratorIterator and LeafIteratorIterator so that the
+// compile time and memory can be measured by script/compile_benchmark.sh.
+// ZIP_WIDTH is the number of zipped iterators, LEAF_DEPTH is the number of
+// levels to flatten, and INSTANTIATIONS is the number of distinct
+// instantiations of each.
+
+#ifndef ZIP_WIDTH
+#define ZIP_WIDTH 2
+#endif
+
+#ifndef LEAF_DEPTH
+#define LEAF_DEPTH 2
+#endif
+
+#ifndef INSTANTIATIONS
+#define INSTANTIATIONS 1
+#endif
+
+namespace {
+
+template <std::size_t Instance, std::size_t Index>
+struct Value {
+  int value;
+};
+
+template <class T, std::size_t Depth>
+struct Nested {
+  using Type = std::vector<typename Nested<T, Depth - 1>::Type>;
+};
+
+template <class T>
+struct Nested<T, 0> {
+  using Type = T;
+};
+
+template <std::size_t Instance, std::size_t... Indexes>
+int Zip(std::index_sequence<Indexes...>) {
+  std::tuple<std::vector<Value<Instance, Indexes>>...> containers;
+  using Iterator = takram::TupleIteratorIterator<
+      typename std::vector<Value<Instance, Indexes>>::iterator...>;
+  auto itr = Iterator(std::get<Indexes>(containers).begin()...);
+  const auto end = Iterator(std::get<Indexes>(containers).end()...);
+  int result{};
+  for (; itr != end; ++itr) {
+    result += std::get<0>(*itr).value;
+  }
+  return result;
+}
+
+template <std::size_t Instance, std::size_t... Indexes>
+int Flatten(std::index_sequence<Indexes...>) {
+  using T = Value<Instance, 0>;
+  typename Nested<T, sizeof...(Indexes)>::Type container;
+  using Iterator = takram::LeafIteratorIterator<typename Nested<
+      T, sizeof...(Indexes) - Indexes>::Type::iterator...>;
+  auto itr = Iterator(container.begin(), container.end());
+  const auto end = Iterator(container.end(), container.end());
+  int result{};
+  for (; itr != end; ++itr) {
+    result += itr->value;
+  }
+  return result;
+}
+
+template <std::size_t... Instances>
+int Run(std::index_sequence<Instances...>) {
+  int result{};
+  using Expand = int[];
+  static_cast<void>(Expand{0, (
+      result += Zip<Instances>(std::make_index_sequence<ZIP_WIDTH>()),
+      result += Flatten<Instances>(std::make_index_sequence<LEAF_DEPTH>()),
+      0)...});
+  return result;
+}
+
+}  // namespace
+
+int main() {
+  return Run(std::make_index_sequence<INSTANTIATIONS>());
+}
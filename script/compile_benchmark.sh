@@ -0,0 +1,91 @@
+#!/bin/bash
+#
+#  compile_benchmark.sh
+#
+#  The MIT License
+#
+#  Copyright (C) 2015 Shota Matsuda
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a
+#  copy of this software and associated documentation files (the "Software"),
+#  to deal in the Software without restriction, including without limitation
+#  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+#  and/or sell copies of the Software, and to permit persons to whom the
+#  Software is furnished to do so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in
+#  all copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+#  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+#  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+#  DEALINGS IN THE SOFTWARE.
+#
+
+#  Measures the compile time and the peak memory of instantiating 2- to 64-way
+#  TupleIteratorIterators and 2- to 8-level LeafIteratorIterators, and the size
+#  of the object file compiled with debug information.
+#
+#  Usage: compile_benchmark.sh [compiler] [instantiations] [flags...]
+
+readonly CXX=${1:-$(which c++)}
+readonly INSTANTIATIONS=${2:-16}
+readonly OPTIONS=${@:3}
+
+readonly PROJECT_DIR="$(cd "$(dirname "$0")/../"; pwd)"
+readonly SOURCE="${PROJECT_DIR}/benchmark/compile_benchmark.cc"
+readonly OUTPUT="$(mktemp -t compile_benchmark.XXXXXX)"
+trap 'rm -f "${OUTPUT}" "${OUTPUT}.debug" "${OUTPUT}.time" "${OUTPUT}.log"' \
+    EXIT
+
+if [[ ! -x "${CXX}" ]]; then
+  echo "C++ compiler was not found."
+  exit 1
+fi
+
+# Compiles the benchmark with the given definitions, and reports the elapsed
+# time and also the maximum resident set size when /usr/bin/time is available.
+# The benchmark is compiled once more with -g to report the size of the object
+# file including debug information.
+measure() {
+  local kind=$1 size=$2
+  local arguments=(-std=c++1y -c -I"${PROJECT_DIR}/src" \
+      -DINSTANTIATIONS="${INSTANTIATIONS}" ${OPTIONS} "${@:3}" "${SOURCE}")
+  local command=("${CXX}" -o "${OUTPUT}" "${arguments[@]}")
+  local elapsed memory="-"
+  TIMEFORMAT="%R"
+  if [[ -x /usr/bin/time && "$(uname)" == "Darwin" ]]; then
+    elapsed=$( { time /usr/bin/time -l "${command[@]}" \
+        2> "${OUTPUT}.time"; } 2>&1 ) || return 1
+    memory=$(awk '/maximum resident set size/ { print int($1 / 1024) }' \
+        "${OUTPUT}.time")
+  elif [[ -x /usr/bin/time ]]; then
+    elapsed=$( { time /usr/bin/time -f "%M" -o "${OUTPUT}.time" \
+        "${command[@]}" 2> "${OUTPUT}.log"; } 2>&1 ) || return 1
+    memory=$(tail -n 1 "${OUTPUT}.time")
+  else
+    elapsed=$( { time "${command[@]}" 2> "${OUTPUT}.log"; } 2>&1 ) || return 1
+  fi
+  "${CXX}" -g -o "${OUTPUT}.debug" "${arguments[@]}" 2> "${OUTPUT}.log" \
+      || return 1
+  local debug=$(( $(wc -c < "${OUTPUT}.debug") / 1024 ))
+  printf "%-8s %6s %10s s %10s KB %10s KB\n" "${kind}" "${size}" \
+      "${elapsed}" "${memory}" "${debug}"
+}
+
+fail() {
+  cat "${OUTPUT}.log" "${OUTPUT}.time" 2> /dev/null
+  exit 1
+}
+
+echo "Instantiations: ${INSTANTIATIONS}"
+printf "%-8s %6s %12s %13s %13s\n" "kind" "size" "time" "memory" "debug"
+for width in 2 4 8 16 32 64; do
+  measure zip "${width}" -DZIP_WIDTH="${width}" -DLEAF_DEPTH=1 || fail
+done
+for depth in 2 3 4 5 6 7 8; do
+  measure flatten "${depth}" -DZIP_WIDTH=1 -DLEAF_DEPTH="${depth}" || fail
+done
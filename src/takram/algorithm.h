@@ -37,8 +37,15 @@ extern const unsigned char version_string[];
 }  // namespace algorithm
 }  // namespace takram
 
+#include "takram/algorithm/interleaved_view.h"
 #include "takram/algorithm/leaf_iterator_iterator.h"
+#include "takram/algorithm/merge_join_iterator.h"
+#include "takram/algorithm/permutation_iterator.h"
+#include "takram/algorithm/stream_leaf_iterator_iterator.h"
+#include "takram/algorithm/stride_iterator.h"
+#include "takram/algorithm/tracked_container.h"
 #include "takram/algorithm/tuple_iterator_iterator.h"
 #include "takram/algorithm/variadic_template.h"
+#include "takram/algorithm/zip_leaf_iterator_iterator.h"
 
 #endif  // TAKRAM_ALGORITHM_H_
@@ -0,0 +1,486 @@
+//
+//  takram/algorithm/interleaved_view.h
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+#ifndef TAKRAM_ALGORITHM_INTERLEAVED_VIEW_H_
+#define TAKRAM_ALGORITHM_INTERLEAVED_VIEW_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define TAKRAM_ALGORITHM_INTERLEAVED_VIEW_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define TAKRAM_ALGORITHM_INTERLEAVED_VIEW_NEON
+#endif
+
+#include "takram/algorithm/stride_iterator.h"
+#include "takram/algorithm/tuple_iterator_iterator.h"
+#include "takram/algorithm/variadic_template.h"
+
+namespace takram {
+namespace algorithm {
+
+// Zips the columns of an interleaved buffer, where each row of the given
+// stride in bytes holds one element of every type at the given offsets, into
+// TupleIteratorIterators of StrideIterators without copying the buffer.
+template <class... Types>
+class InterleavedView final {
+ public:
+  using Iterator = TupleIteratorIterator<StrideIterator<Types>...>;
+  template <std::size_t Index>
+  using ColumnIterator = StrideIterator<typename At<Index, Types...>::Type>;
+
+ public:
+  template <class Data>
+  InterleavedView(Data *data, std::size_t size, std::size_t stride,
+                  decltype(sizeof(Types))... offsets);
+
+  // Copy semantics
+  InterleavedView(const InterleavedView&) = default;
+  InterleavedView& operator=(const InterleavedView&) = default;
+
+  // Iterator
+  Iterator begin() const;
+  Iterator end() const;
+  template <std::size_t Index>
+  ColumnIterator<Index> column_begin() const;
+  template <std::size_t Index>
+  ColumnIterator<Index> column_end() const;
+
+  // Attributes
+  bool empty() const { return !size_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  template <std::size_t... Indexes>
+  Iterator advance(std::size_t n, std::index_sequence<Indexes...>) const;
+
+ private:
+  std::tuple<StrideIterator<Types>...> begins_;
+  std::size_t size_;
+};
+
+#pragma mark -
+
+template <class... Types>
+template <class Data>
+inline InterleavedView<Types...>::InterleavedView(
+    Data *data, std::size_t size, std::size_t stride,
+    decltype(sizeof(Types))... offsets)
+    : begins_(StrideIterator<Types>(reinterpret_cast<Types *>(
+          static_cast<std::conditional_t<std::is_const<Types>::value,
+                                         const unsigned char,
+                                         unsigned char> *>(data) + offsets),
+          stride)...),
+      size_(size) {}
+
+template <class... Types>
+inline InterleavedView<Types...> interleaved_view(
+    void *data, std::size_t size, std::size_t stride,
+    decltype(sizeof(Types))... offsets) {
+  return InterleavedView<Types...>(data, size, stride, offsets...);
+}
+
+template <class... Types>
+inline InterleavedView<const Types...> interleaved_view(
+    const void *data, std::size_t size, std::size_t stride,
+    decltype(sizeof(Types))... offsets) {
+  return InterleavedView<const Types...>(data, size, stride, offsets...);
+}
+
+#pragma mark Iterator
+
+template <class... Types>
+inline typename InterleavedView<Types...>::Iterator
+    InterleavedView<Types...>::begin() const {
+  return advance(0, std::index_sequence_for<Types...>());
+}
+
+template <class... Types>
+inline typename InterleavedView<Types...>::Iterator
+    InterleavedView<Types...>::end() const {
+  return advance(size_, std::index_sequence_for<Types...>());
+}
+
+template <class... Types>
+template <std::size_t Index>
+inline typename InterleavedView<Types...>::template ColumnIterator<Index>
+    InterleavedView<Types...>::column_begin() const {
+  return std::get<Index>(begins_);
+}
+
+template <class... Types>
+template <std::size_t Index>
+inline typename InterleavedView<Types...>::template ColumnIterator<Index>
+    InterleavedView<Types...>::column_end() const {
+  return std::get<Index>(begins_) + size_;
+}
+
+template <class... Types>
+template <std::size_t... Indexes>
+inline typename InterleavedView<Types...>::Iterator
+    InterleavedView<Types...>::advance(
+        std::size_t n, std::index_sequence<Indexes...>) const {
+  return Iterator((std::get<Indexes>(begins_) + n)...);
+}
+
+#pragma mark Conversion
+
+namespace interleaved_kernel {
+
+// Number of rows that each step of the kernels converts
+constexpr std::size_t kRows = 4;
+
+// Converts the rows of a buffer that packs the given number of 32-bit
+// components without gaps, kRows rows at a time. Only the bits are moved, so
+// the kernels work on any 4-byte type through float pointers.
+template <std::size_t Size>
+struct Kernel {
+  static constexpr bool available = false;
+};
+
+#if defined(TAKRAM_ALGORITHM_INTERLEAVED_VIEW_SSE)
+
+template <>
+struct Kernel<2> {
+  static constexpr bool available = true;
+
+  static void deinterleave(const float *data, std::size_t rows,
+                           float *x, float *y) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 2 * kRows) {
+      const auto a = _mm_loadu_ps(data);
+      const auto b = _mm_loadu_ps(data + 4);
+      _mm_storeu_ps(x + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+      _mm_storeu_ps(y + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+  }
+
+  static void interleave(float *data, std::size_t rows,
+                         const float *x, const float *y) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 2 * kRows) {
+      const auto a = _mm_loadu_ps(x + i);
+      const auto b = _mm_loadu_ps(y + i);
+      _mm_storeu_ps(data, _mm_unpacklo_ps(a, b));
+      _mm_storeu_ps(data + 4, _mm_unpackhi_ps(a, b));
+    }
+  }
+};
+
+template <>
+struct Kernel<3> {
+  static constexpr bool available = true;
+
+  // Picks the elements at the given indexes of a, b, c and d respectively
+  template <int I, int J, int K, int L>
+  static __m128 pick(__m128 a, __m128 b, __m128 c, __m128 d) {
+    return _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(J, J, I, I)),
+                          _mm_shuffle_ps(c, d, _MM_SHUFFLE(L, L, K, K)),
+                          _MM_SHUFFLE(2, 0, 2, 0));
+  }
+
+  static void deinterleave(const float *data, std::size_t rows,
+                           float *x, float *y, float *z) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 3 * kRows) {
+      const auto a = _mm_loadu_ps(data);      // x0 y0 z0 x1
+      const auto b = _mm_loadu_ps(data + 4);  // y1 z1 x2 y2
+      const auto c = _mm_loadu_ps(data + 8);  // z2 x3 y3 z3
+      _mm_storeu_ps(x + i, pick<0, 3, 2, 1>(a, a, b, c));
+      _mm_storeu_ps(y + i, pick<1, 0, 3, 2>(a, b, b, c));
+      _mm_storeu_ps(z + i, pick<2, 1, 0, 3>(a, b, c, c));
+    }
+  }
+
+  static void interleave(float *data, std::size_t rows,
+                         const float *x, const float *y, const float *z) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 3 * kRows) {
+      const auto a = _mm_loadu_ps(x + i);
+      const auto b = _mm_loadu_ps(y + i);
+      const auto c = _mm_loadu_ps(z + i);
+      _mm_storeu_ps(data, pick<0, 0, 0, 1>(a, b, c, a));
+      _mm_storeu_ps(data + 4, pick<1, 1, 2, 2>(b, c, a, b));
+      _mm_storeu_ps(data + 8, pick<2, 3, 3, 3>(c, a, b, c));
+    }
+  }
+};
+
+template <>
+struct Kernel<4> {
+  static constexpr bool available = true;
+
+  static void deinterleave(const float *data, std::size_t rows,
+                           float *x, float *y, float *z, float *w) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 4 * kRows) {
+      auto a = _mm_loadu_ps(data);
+      auto b = _mm_loadu_ps(data + 4);
+      auto c = _mm_loadu_ps(data + 8);
+      auto d = _mm_loadu_ps(data + 12);
+      _MM_TRANSPOSE4_PS(a, b, c, d);
+      _mm_storeu_ps(x + i, a);
+      _mm_storeu_ps(y + i, b);
+      _mm_storeu_ps(z + i, c);
+      _mm_storeu_ps(w + i, d);
+    }
+  }
+
+  static void interleave(float *data, std::size_t rows, const float *x,
+                         const float *y, const float *z, const float *w) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 4 * kRows) {
+      auto a = _mm_loadu_ps(x + i);
+      auto b = _mm_loadu_ps(y + i);
+      auto c = _mm_loadu_ps(z + i);
+      auto d = _mm_loadu_ps(w + i);
+      _MM_TRANSPOSE4_PS(a, b, c, d);
+      _mm_storeu_ps(data, a);
+      _mm_storeu_ps(data + 4, b);
+      _mm_storeu_ps(data + 8, c);
+      _mm_storeu_ps(data + 12, d);
+    }
+  }
+};
+
+#elif defined(TAKRAM_ALGORITHM_INTERLEAVED_VIEW_NEON)
+
+template <>
+struct Kernel<2> {
+  static constexpr bool available = true;
+
+  static void deinterleave(const float *data, std::size_t rows,
+                           float *x, float *y) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 2 * kRows) {
+      const auto v = vld2q_f32(data);
+      vst1q_f32(x + i, v.val[0]);
+      vst1q_f32(y + i, v.val[1]);
+    }
+  }
+
+  static void interleave(float *data, std::size_t rows,
+                         const float *x, const float *y) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 2 * kRows) {
+      vst2q_f32(data, (float32x4x2_t{{vld1q_f32(x + i), vld1q_f32(y + i)}}));
+    }
+  }
+};
+
+template <>
+struct Kernel<3> {
+  static constexpr bool available = true;
+
+  static void deinterleave(const float *data, std::size_t rows,
+                           float *x, float *y, float *z) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 3 * kRows) {
+      const auto v = vld3q_f32(data);
+      vst1q_f32(x + i, v.val[0]);
+      vst1q_f32(y + i, v.val[1]);
+      vst1q_f32(z + i, v.val[2]);
+    }
+  }
+
+  static void interleave(float *data, std::size_t rows,
+                         const float *x, const float *y, const float *z) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 3 * kRows) {
+      vst3q_f32(data, (float32x4x3_t{{
+          vld1q_f32(x + i), vld1q_f32(y + i), vld1q_f32(z + i)}}));
+    }
+  }
+};
+
+template <>
+struct Kernel<4> {
+  static constexpr bool available = true;
+
+  static void deinterleave(const float *data, std::size_t rows,
+                           float *x, float *y, float *z, float *w) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 4 * kRows) {
+      const auto v = vld4q_f32(data);
+      vst1q_f32(x + i, v.val[0]);
+      vst1q_f32(y + i, v.val[1]);
+      vst1q_f32(z + i, v.val[2]);
+      vst1q_f32(w + i, v.val[3]);
+    }
+  }
+
+  static void interleave(float *data, std::size_t rows, const float *x,
+                         const float *y, const float *z, const float *w) {
+    for (std::size_t i{}; i < rows; i += kRows, data += 4 * kRows) {
+      vst4q_f32(data, (float32x4x4_t{{
+          vld1q_f32(x + i), vld1q_f32(y + i),
+          vld1q_f32(z + i), vld1q_f32(w + i)}}));
+    }
+  }
+};
+
+#endif  // TAKRAM_ALGORITHM_INTERLEAVED_VIEW_NEON
+
+// Whether the columns can be converted by a kernel when they turn out to be
+// packed at run time, given the pointers to the separate ranges
+template <class... Types>
+using Available = std::integral_constant<bool,
+    Kernel<sizeof...(Types)>::available &&
+    All<(sizeof(Types) == sizeof(float))...>::value>;
+
+// Returns the number of rows that can be converted by a kernel, which is zero
+// unless the columns are packed in this order from the beginning of a row
+template <class... Types, std::size_t... Indexes>
+inline std::size_t packed_rows(const InterleavedView<Types...>& view,
+                               std::index_sequence<Indexes...>) {
+  if (view.size() < kRows) {
+    return 0;
+  }
+  const std::ptrdiff_t stride = sizeof...(Types) * sizeof(float);
+  const auto data = reinterpret_cast<const unsigned char *>(
+      &*view.template column_begin<0>());
+  const bool packed[] = {
+    view.template column_begin<Indexes>().stride() == stride &&
+    reinterpret_cast<const unsigned char *>(
+        &*view.template column_begin<Indexes>()) ==
+        data + Indexes * sizeof(float)...
+  };
+  if (!std::all_of(std::begin(packed), std::end(packed),
+                   [](bool value) { return value; })) {
+    return 0;
+  }
+  return view.size() / kRows * kRows;
+}
+
+// Copies the rows one by one
+template <class Iterator, class OutputIterator>
+inline OutputIterator deinterleave_rows(Iterator first, Iterator last,
+                                        OutputIterator result) {
+  return std::copy(first, last, result);
+}
+
+template <class Iterator, class InputIterator>
+inline InputIterator interleave_rows(Iterator itr, Iterator end,
+                                     InputIterator first) {
+  for (; itr != end; ++itr) {
+    *itr = *first++;
+  }
+  return first;
+}
+
+// Converts the packed rows with a kernel and the rest with the scalar loop
+template <class... Types, class... Pointers, std::size_t... Indexes>
+inline TupleIteratorIterator<Pointers...> deinterleave(
+    const InterleavedView<Types...>& view,
+    std::index_sequence<Indexes...> indexes, std::true_type,
+    Pointers... results) {
+  const auto rows = packed_rows(view, indexes);
+  if (rows) {
+    Kernel<sizeof...(Types)>::deinterleave(
+        reinterpret_cast<const float *>(&*view.template column_begin<0>()),
+        rows, reinterpret_cast<float *>(results)...);
+  }
+  return deinterleave_rows(
+      view.begin() + rows, view.end(),
+      TupleIteratorIterator<Pointers...>((results + rows)...));
+}
+
+template <class... Types, class... Iterators, std::size_t... Indexes>
+inline TupleIteratorIterator<Iterators...> deinterleave(
+    const InterleavedView<Types...>& view, std::index_sequence<Indexes...>,
+    std::false_type, Iterators... results) {
+  return deinterleave_rows(view.begin(), view.end(),
+                           TupleIteratorIterator<Iterators...>(results...));
+}
+
+template <class... Types, class... Pointers, std::size_t... Indexes>
+inline TupleIteratorIterator<Pointers...> interleave(
+    const InterleavedView<Types...>& view,
+    std::index_sequence<Indexes...> indexes, std::true_type,
+    Pointers... firsts) {
+  const auto rows = packed_rows(view, indexes);
+  if (rows) {
+    Kernel<sizeof...(Types)>::interleave(
+        reinterpret_cast<float *>(&*view.template column_begin<0>()),
+        rows, reinterpret_cast<const float *>(firsts)...);
+  }
+  return interleave_rows(
+      view.begin() + rows, view.end(),
+      TupleIteratorIterator<Pointers...>((firsts + rows)...));
+}
+
+template <class... Types, class... Iterators, std::size_t... Indexes>
+inline TupleIteratorIterator<Iterators...> interleave(
+    const InterleavedView<Types...>& view, std::index_sequence<Indexes...>,
+    std::false_type, Iterators... firsts) {
+  return interleave_rows(view.begin(), view.end(),
+                         TupleIteratorIterator<Iterators...>(firsts...));
+}
+
+}  // namespace interleaved_kernel
+
+// Copies the columns of the view into the separate ranges beginning at the
+// given iterators, reading the buffer only once from front to back. When the
+// iterators are pointers to 2, 3 or 4 columns of 4-byte types packed without
+// gaps, such as the components of float vectors, the rows are converted with
+// SSE or NEON shuffles where available.
+template <class... Types, class... OutputIterators>
+inline TupleIteratorIterator<OutputIterators...> deinterleave(
+    const InterleavedView<Types...>& view, OutputIterators... results) {
+  static_assert(sizeof...(Types) == sizeof...(OutputIterators),
+                "Number of iterators must match the number of columns");
+  using Available = std::integral_constant<bool,
+      interleaved_kernel::Available<Types...>::value &&
+      All<std::is_same<OutputIterators,
+                       std::remove_const_t<Types> *>::value...>::value>;
+  return interleaved_kernel::deinterleave(
+      view, std::index_sequence_for<Types...>(), Available(), results...);
+}
+
+// Copies the separate ranges beginning at the given iterators into the
+// columns of the view, writing the buffer only once from front to back, with
+// the same kernels as deinterleave for packed columns.
+template <class... Types, class... InputIterators>
+inline TupleIteratorIterator<InputIterators...> interleave(
+    const InterleavedView<Types...>& view, InputIterators... firsts) {
+  static_assert(sizeof...(Types) == sizeof...(InputIterators),
+                "Number of iterators must match the number of columns");
+  using Available = std::integral_constant<bool,
+      interleaved_kernel::Available<Types...>::value &&
+      All<(!std::is_const<Types>::value &&
+           std::is_pointer<InputIterators>::value &&
+           std::is_same<std::remove_const_t<
+                            std::remove_pointer_t<InputIterators>>,
+                        Types>::value)...>::value>;
+  return interleaved_kernel::interleave(
+      view, std::index_sequence_for<Types...>(), Available(), firsts...);
+}
+
+}  // namespace algorithm
+
+using algorithm::InterleavedView;
+
+}  // namespace takram
+
+#endif  // TAKRAM_ALGORITHM_INTERLEAVED_VIEW_H_
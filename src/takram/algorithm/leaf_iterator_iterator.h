@@ -28,53 +28,194 @@
 #ifndef TAKRAM_ALGORITHM_LEAF_ITERATOR_ITERATOR_H_
 #define TAKRAM_ALGORITHM_LEAF_ITERATOR_ITERATOR_H_
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
 #include <iterator>
+#include <tuple>
+#include <utility>
 
+#include "takram/algorithm/tuple_iterator_iterator.h"
 #include "takram/algorithm/variadic_template.h"
 
 namespace takram {
 namespace algorithm {
 
+// Describes how LeafIteratorIterator tells that a level has reached its end.
+// Specialize this for iterators that need other behaviors.
+template <class Iterator>
+struct LeafIteratorTraits {
+  static bool equals(const Iterator& lhs, const Iterator& rhs) {
+    return lhs == rhs;
+  }
+};
+
+// Only the first iterators of zipped levels are compared, so that the cost
+// does not depend on the number of zipped containers. Every container is
+// checked to reach the ends together in debug builds.
+template <class... Iterators>
+struct LeafIteratorTraits<TupleIteratorIterator<Iterators...>> {
+  using Iterator = TupleIteratorIterator<Iterators...>;
+
+  static bool equals(const Iterator& lhs, const Iterator& rhs) {
+    const auto result = std::get<0>(lhs.iterators()) ==
+                        std::get<0>(rhs.iterators());
+    assert(consistent(lhs, rhs, result,
+                      std::index_sequence_for<Iterators...>()));
+    return result;
+  }
+
+ private:
+  // Whether every container reaches the end of a level together with the
+  // first one
+  template <std::size_t... Indexes>
+  static bool consistent(const Iterator& lhs, const Iterator& rhs,
+                         bool expected, std::index_sequence<Indexes...>) {
+    bool result{true};
+    using Expand = bool[];
+    static_cast<void>(Expand{true, (result = result &&
+        ((std::get<Indexes>(lhs.iterators()) ==
+          std::get<Indexes>(rhs.iterators())) == expected))...});
+    return result;
+  }
+};
+
+// The ranges of inner levels are obtained through this namespace, where
+// std::begin and std::end are overloaded for the elements of zipped levels,
+// which are tuples of references to containers. Calls for ordinary containers
+// resolve directly to std::begin and std::end without any extra function per
+// level.
+namespace leaf_range {
+
+using std::begin;
+using std::end;
+
+template <class... Containers>
+using Iterator = TupleIteratorIterator<
+    decltype(std::begin(std::declval<Containers&>()))...>;
+
+template <class... Containers, std::size_t... Indexes>
+inline Iterator<Containers...> begin(
+    const std::tuple<Containers&...>& containers,
+    std::index_sequence<Indexes...>) {
+  return Iterator<Containers...>(std::begin(std::get<Indexes>(containers))...);
+}
+
+template <class... Containers, std::size_t... Indexes>
+inline Iterator<Containers...> end(
+    const std::tuple<Containers&...>& containers,
+    std::index_sequence<Indexes...>) {
+  return Iterator<Containers...>(std::end(std::get<Indexes>(containers))...);
+}
+
+template <class... Containers>
+inline Iterator<Containers...> begin(
+    const std::tuple<Containers&...>& containers) {
+  return begin(containers, std::index_sequence_for<Containers...>());
+}
+
+template <class... Containers>
+inline Iterator<Containers...> end(
+    const std::tuple<Containers&...>& containers) {
+  return end(containers, std::index_sequence_for<Containers...>());
+}
+
+}  // namespace leaf_range
+
+// Index of the current element at a level, which is counted only by the
+// iterators that enumerate paths, so that the others pay nothing for it.
+template <bool Enumerated>
+class LeafIndex;
+
+template <>
+class LeafIndex<false> {
+ protected:
+  void set_index(std::size_t) {}
+  void increment_index() {}
+};
+
+template <>
+class LeafIndex<true> {
+ protected:
+  LeafIndex() : index_() {}
+
+  std::size_t index() const { return index_; }
+  void set_index(std::size_t index) { index_ = index; }
+  void increment_index() { ++index_; }
+
+ private:
+  std::size_t index_;
+};
+
+#pragma mark -
+
 // Primary template
+template <bool Enumerated, class... Iterators>
+class BasicLeafIteratorIterator;
+
+template <class... Iterators>
+using LeafIteratorIterator = BasicLeafIteratorIterator<false, Iterators...>;
+
+// Maintains the indexes of the current element at each level, which makes
+// the member function path available.
 template <class... Iterators>
-class LeafIteratorIterator;
+using EnumeratedLeafIteratorIterator =
+    BasicLeafIteratorIterator<true, Iterators...>;
 
 #pragma mark -
 
 // Terminating partial specialization
-template <class Iterator>
-class LeafIteratorIterator<Iterator> final
+template <bool Enumerated, class Iterator>
+class BasicLeafIteratorIterator<Enumerated, Iterator> final
     : public std::iterator<std::forward_iterator_tag,
                            typename Iterator::value_type,
                            typename Iterator::difference_type,
                            typename Iterator::pointer,
-                           typename Iterator::reference> {
+                           typename Iterator::reference>,
+      private LeafIndex<Enumerated> {
+ public:
+  using Path = std::array<std::size_t, 1>;
+
  private:
   using Type = typename Iterator::value_type;
   using Pointer = typename Iterator::pointer;
   using Reference = typename Iterator::reference;
 
  public:
-  LeafIteratorIterator();
-  LeafIteratorIterator(Iterator begin, Iterator end);
+  BasicLeafIteratorIterator();
+  BasicLeafIteratorIterator(Iterator begin, Iterator end);
+  BasicLeafIteratorIterator(Iterator begin, Iterator end, const Path& path);
 
   // Copy semantics
-  LeafIteratorIterator(const LeafIteratorIterator&) = default;
-  LeafIteratorIterator& operator=(const LeafIteratorIterator&) = default;
+  BasicLeafIteratorIterator(const BasicLeafIteratorIterator&) = default;
+  BasicLeafIteratorIterator& operator=(
+      const BasicLeafIteratorIterator&) = default;
 
   // Comparison
-  template <class Iter>
-  friend bool operator==(const LeafIteratorIterator<Iter>& lhs,
-                         const LeafIteratorIterator<Iter>& rhs);
-  template <class Iter>
-  friend bool operator!=(const LeafIteratorIterator<Iter>& lhs,
-                         const LeafIteratorIterator<Iter>& rhs);
+  template <bool E, class Iter>
+  friend bool operator==(const BasicLeafIteratorIterator<E, Iter>& lhs,
+                         const BasicLeafIteratorIterator<E, Iter>& rhs);
+  template <bool E, class Iter>
+  friend bool operator!=(const BasicLeafIteratorIterator<E, Iter>& lhs,
+                         const BasicLeafIteratorIterator<E, Iter>& rhs);
 
   // Iterator
   Reference operator*() const;
   Pointer operator->() const { return &operator*(); }
-  LeafIteratorIterator& operator++();
-  const LeafIteratorIterator& operator++(int);
+  BasicLeafIteratorIterator& operator++();
+  BasicLeafIteratorIterator operator++(int);
+
+  // Indexes of the current element at each level, outermost first
+  Path path() const;
+
+ private:
+  template <bool E, class... Iters>
+  friend class BasicLeafIteratorIterator;
+
+  BasicLeafIteratorIterator(Iterator begin, Iterator end,
+                            const std::size_t *path);
+  void collect(std::size_t *path) const;
 
  private:
   Iterator current_;
@@ -83,172 +224,292 @@ class LeafIteratorIterator<Iterator> final
 #pragma mark -
 
 // Recursive partial specialization
-template <class Iterator, class... RestIterators>
-class LeafIteratorIterator<Iterator, RestIterators...> final
+template <bool Enumerated, class Iterator, class... RestIterators>
+class BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...> final
     : public std::iterator<
           std::forward_iterator_tag,
           typename Last<Iterator, RestIterators...>::Type::value_type,
           typename Last<Iterator, RestIterators...>::Type::difference_type,
           typename Last<Iterator, RestIterators...>::Type::pointer,
-          typename Last<Iterator, RestIterators...>::Type::reference> {
+          typename Last<Iterator, RestIterators...>::Type::reference>,
+      private LeafIndex<Enumerated> {
+ public:
+  using Path = std::array<std::size_t, 1 + sizeof...(RestIterators)>;
+
  private:
   using Type = typename Last<Iterator, RestIterators...>::Type::value_type;
   using Pointer = typename Last<Iterator, RestIterators...>::Type::pointer;
   using Reference = typename Last<Iterator, RestIterators...>::Type::reference;
+  using Traits = LeafIteratorTraits<Iterator>;
+  using RestIterator = BasicLeafIteratorIterator<Enumerated, RestIterators...>;
 
  public:
-  LeafIteratorIterator();
-  LeafIteratorIterator(Iterator begin, Iterator end);
+  BasicLeafIteratorIterator();
+  BasicLeafIteratorIterator(Iterator begin, Iterator end);
+  BasicLeafIteratorIterator(Iterator begin, Iterator end, const Path& path);
 
   // Copy semantics
-  LeafIteratorIterator(const LeafIteratorIterator&) = default;
-  LeafIteratorIterator& operator=(const LeafIteratorIterator&) = default;
+  BasicLeafIteratorIterator(const BasicLeafIteratorIterator&) = default;
+  BasicLeafIteratorIterator& operator=(
+      const BasicLeafIteratorIterator&) = default;
 
   // Comparison
-  template <class Iter, class RestIter, class... RestIters>
+  template <bool E, class Iter, class RestIter, class... RestIters>
   friend bool operator==(
-      const LeafIteratorIterator<Iter, RestIter, RestIters...>& lhs,
-      const LeafIteratorIterator<Iter, RestIter, RestIters...>& rhs);
-  template <class Iter, class RestIter, class... RestIters>
+      const BasicLeafIteratorIterator<E, Iter, RestIter, RestIters...>& lhs,
+      const BasicLeafIteratorIterator<E, Iter, RestIter, RestIters...>& rhs);
+  template <bool E, class Iter, class RestIter, class... RestIters>
   friend bool operator!=(
-      const LeafIteratorIterator<Iter, RestIter, RestIters...>& lhs,
-      const LeafIteratorIterator<Iter, RestIter, RestIters...>& rhs);
+      const BasicLeafIteratorIterator<E, Iter, RestIter, RestIters...>& lhs,
+      const BasicLeafIteratorIterator<E, Iter, RestIter, RestIters...>& rhs);
 
   // Iterator
   Reference operator*() const;
   Pointer operator->() const { return &operator*(); }
-  LeafIteratorIterator& operator++();
-  const LeafIteratorIterator& operator++(int);
+  BasicLeafIteratorIterator& operator++();
+  BasicLeafIteratorIterator operator++(int);
+
+  // Indexes of the current element at each level, outermost first
+  Path path() const;
 
  private:
+  template <bool E, class... Iters>
+  friend class BasicLeafIteratorIterator;
+
+  BasicLeafIteratorIterator(Iterator begin, Iterator end,
+                            const std::size_t *path);
   void validate();
+  void collect(std::size_t *path) const;
 
  private:
   Iterator current_;
   Iterator end_;
-  LeafIteratorIterator<RestIterators...> rest_;
+  RestIterator rest_;
 };
 
 #pragma mark -
 
-template <class Iterator>
-inline LeafIteratorIterator<Iterator>::LeafIteratorIterator() : current_() {}
+template <bool Enumerated, class Iterator>
+inline BasicLeafIteratorIterator<Enumerated, Iterator>::
+    BasicLeafIteratorIterator()
+    : current_() {}
 
-template <class Iterator>
-inline LeafIteratorIterator<Iterator>::LeafIteratorIterator(
-    Iterator begin, Iterator end)
+template <bool Enumerated, class Iterator>
+inline BasicLeafIteratorIterator<Enumerated, Iterator>::
+    BasicLeafIteratorIterator(Iterator begin, Iterator end)
     : current_(begin) {}
 
-template <class Iterator, class... RestIterators>
-inline LeafIteratorIterator<Iterator, RestIterators...>::LeafIteratorIterator()
+template <bool Enumerated, class Iterator>
+inline BasicLeafIteratorIterator<Enumerated, Iterator>::
+    BasicLeafIteratorIterator(Iterator begin, Iterator end, const Path& path)
+    : BasicLeafIteratorIterator(begin, end, path.data()) {}
+
+template <bool Enumerated, class Iterator>
+inline BasicLeafIteratorIterator<Enumerated, Iterator>::
+    BasicLeafIteratorIterator(Iterator begin, Iterator end,
+                              const std::size_t *path)
+    : current_(begin) {
+  const auto index = std::min(*path, static_cast<std::size_t>(
+      std::distance(begin, end)));
+  std::advance(current_, index);
+  this->set_index(index);
+}
+
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>::
+    BasicLeafIteratorIterator()
     : current_(),
       end_() {}
 
-template <class Iterator, class... RestIterators>
-inline LeafIteratorIterator<Iterator, RestIterators...>::LeafIteratorIterator(
-    Iterator begin, Iterator end)
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>::
+    BasicLeafIteratorIterator(Iterator begin, Iterator end)
+    : current_(begin),
+      end_(end) {
+  validate();
+}
+
+// Moves to the leaf at the given path, or to the next leaf when the path does
+// not point to any leaf.
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>::
+    BasicLeafIteratorIterator(Iterator begin, Iterator end, const Path& path)
+    : BasicLeafIteratorIterator(begin, end, path.data()) {}
+
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>::
+    BasicLeafIteratorIterator(Iterator begin, Iterator end,
+                              const std::size_t *path)
     : current_(begin),
       end_(end) {
+  const auto index = std::min(*path, static_cast<std::size_t>(
+      std::distance(begin, end)));
+  std::advance(current_, index);
+  this->set_index(index);
+  if (!Traits::equals(current_, end_)) {
+    auto&& element = *current_;
+    const auto last = leaf_range::end(element);
+    rest_ = RestIterator(leaf_range::begin(element), last, path + 1);
+    if (!(rest_ == RestIterator(last, last))) {
+      return;
+    }
+    ++current_;
+    this->increment_index();
+  }
   validate();
 }
 
 #pragma mark Comparison
 
-template <class Iterator>
-inline bool operator==(const LeafIteratorIterator<Iterator>& lhs,
-                       const LeafIteratorIterator<Iterator>& rhs) {
-  return lhs.current_ == rhs.current_;
+template <bool Enumerated, class Iterator>
+inline bool operator==(
+    const BasicLeafIteratorIterator<Enumerated, Iterator>& lhs,
+    const BasicLeafIteratorIterator<Enumerated, Iterator>& rhs) {
+  return LeafIteratorTraits<Iterator>::equals(lhs.current_, rhs.current_);
 }
 
-template <class Iterator>
-inline bool operator!=(const LeafIteratorIterator<Iterator>& lhs,
-                       const LeafIteratorIterator<Iterator>& rhs) {
+template <bool Enumerated, class Iterator>
+inline bool operator!=(
+    const BasicLeafIteratorIterator<Enumerated, Iterator>& lhs,
+    const BasicLeafIteratorIterator<Enumerated, Iterator>& rhs) {
   return !(lhs == rhs);
 }
 
-template <class Iterator, class RestIterator, class... RestIterators>
+template <bool Enumerated, class Iterator,
+          class RestIterator, class... RestIterators>
 inline bool operator==(
-    const LeafIteratorIterator<Iterator, RestIterator, RestIterators...>& lhs,
-    const LeafIteratorIterator<Iterator, RestIterator, RestIterators...>& rhs) {
-  return (lhs.current_ == rhs.current_ ||
-          (lhs.current_ == Iterator() && rhs.current_ == rhs.end_) ||
-          (lhs.current_ == lhs.end_ && rhs.current_ == Iterator())) &&
+    const BasicLeafIteratorIterator<
+        Enumerated, Iterator, RestIterator, RestIterators...>& lhs,
+    const BasicLeafIteratorIterator<
+        Enumerated, Iterator, RestIterator, RestIterators...>& rhs) {
+  // Default-constructed iterators compare equal to past-the-end iterators,
+  // because their begin and end are both value-initialized.
+  using Traits = LeafIteratorTraits<Iterator>;
+  return (Traits::equals(lhs.current_, rhs.current_) ||
+          (Traits::equals(lhs.current_, lhs.end_) &&
+           Traits::equals(rhs.current_, rhs.end_))) &&
          lhs.rest_ == rhs.rest_;
 }
 
-template <class Iterator, class RestIterator, class... RestIterators>
+template <bool Enumerated, class Iterator,
+          class RestIterator, class... RestIterators>
 inline bool operator!=(
-    const LeafIteratorIterator<Iterator, RestIterator, RestIterators...>& lhs,
-    const LeafIteratorIterator<Iterator, RestIterator, RestIterators...>& rhs) {
+    const BasicLeafIteratorIterator<
+        Enumerated, Iterator, RestIterator, RestIterators...>& lhs,
+    const BasicLeafIteratorIterator<
+        Enumerated, Iterator, RestIterator, RestIterators...>& rhs) {
   return !(lhs == rhs);
 }
 
 #pragma mark Iterator
 
-template <class Iterator>
-inline typename LeafIteratorIterator<Iterator>::Reference
-    LeafIteratorIterator<Iterator>::operator*() const {
+template <bool Enumerated, class Iterator>
+inline typename BasicLeafIteratorIterator<Enumerated, Iterator>::Reference
+    BasicLeafIteratorIterator<Enumerated, Iterator>::operator*() const {
   return *current_;
 }
 
-template <class Iterator, class... RestIterators>
-inline typename LeafIteratorIterator<Iterator, RestIterators...>::Reference
-    LeafIteratorIterator<Iterator, RestIterators...>::operator*() const {
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline typename BasicLeafIteratorIterator<
+    Enumerated, Iterator, RestIterators...>::Reference
+    BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>::
+        operator*() const {
   return *rest_;
 }
 
-template <class Iterator>
-inline LeafIteratorIterator<Iterator>&
-    LeafIteratorIterator<Iterator>::operator++() {
+template <bool Enumerated, class Iterator>
+inline BasicLeafIteratorIterator<Enumerated, Iterator>&
+    BasicLeafIteratorIterator<Enumerated, Iterator>::operator++() {
   ++current_;
+  this->increment_index();
   return *this;
 }
 
-template <class Iterator, class... RestIterators>
-inline LeafIteratorIterator<Iterator, RestIterators...>&
-    LeafIteratorIterator<Iterator, RestIterators...>::operator++() {
-  using RestIterator = LeafIteratorIterator<RestIterators...>;
-  if (++rest_ == RestIterator(std::end(*current_), std::end(*current_))) {
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>&
+    BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>::
+        operator++() {
+  const auto last = leaf_range::end(*current_);
+  if (++rest_ == RestIterator(last, last)) {
     ++current_;
+    this->increment_index();
     validate();
   }
   return *this;
 }
 
-template <class Iterator, class... RestIterators>
-inline void LeafIteratorIterator<Iterator, RestIterators...>::validate() {
-  using RestIterator = LeafIteratorIterator<RestIterators...>;
-  if (current_ == end_) {
-    rest_ = RestIterator();
-    return;
-  }
-  rest_ = RestIterator(std::begin(*current_), std::end(*current_));
-  while (rest_ == RestIterator() && current_ != end_) {
-    ++current_;
-    if (current_ != end_) {
-      rest_ = RestIterator(std::begin(*current_), std::end(*current_));
+template <bool Enumerated, class Iterator>
+inline BasicLeafIteratorIterator<Enumerated, Iterator>
+    BasicLeafIteratorIterator<Enumerated, Iterator>::operator++(int) {
+  BasicLeafIteratorIterator result(*this);
+  operator++();
+  return result;
+}
+
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>
+    BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>::
+        operator++(int) {
+  BasicLeafIteratorIterator result(*this);
+  operator++();
+  return result;
+}
+
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline void BasicLeafIteratorIterator<
+    Enumerated, Iterator, RestIterators...>::validate() {
+  for (; !Traits::equals(current_, end_);
+       ++current_, this->increment_index()) {
+    auto&& element = *current_;
+    const auto last = leaf_range::end(element);
+    rest_ = RestIterator(leaf_range::begin(element), last);
+    if (!(rest_ == RestIterator(last, last))) {
+      return;
     }
   }
+  rest_ = RestIterator();
 }
 
-template <class Iterator>
-inline const LeafIteratorIterator<Iterator>&
-    LeafIteratorIterator<Iterator>::operator++(int) {
-  LeafIteratorIterator result(*this);
-  operator++();
+#pragma mark Path
+
+template <bool Enumerated, class Iterator>
+inline typename BasicLeafIteratorIterator<Enumerated, Iterator>::Path
+    BasicLeafIteratorIterator<Enumerated, Iterator>::path() const {
+  static_assert(Enumerated, "Requires EnumeratedLeafIteratorIterator");
+  Path result;
+  collect(result.data());
   return result;
 }
 
-template <class Iterator, class... RestIterators>
-inline const LeafIteratorIterator<Iterator, RestIterators...>&
-    LeafIteratorIterator<Iterator, RestIterators...>::operator++(int) {
-  LeafIteratorIterator result(*this);
-  operator++();
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline typename BasicLeafIteratorIterator<
+    Enumerated, Iterator, RestIterators...>::Path
+    BasicLeafIteratorIterator<Enumerated, Iterator, RestIterators...>::
+        path() const {
+  static_assert(Enumerated, "Requires EnumeratedLeafIteratorIterator");
+  Path result;
+  collect(result.data());
   return result;
 }
 
+template <bool Enumerated, class Iterator>
+inline void BasicLeafIteratorIterator<Enumerated, Iterator>::collect(
+    std::size_t *path) const {
+  *path = this->index();
+}
+
+template <bool Enumerated, class Iterator, class... RestIterators>
+inline void BasicLeafIteratorIterator<
+    Enumerated, Iterator, RestIterators...>::collect(
+        std::size_t *path) const {
+  *path = this->index();
+  rest_.collect(path + 1);
+}
+
 }  // namespace algorithm
 
+using algorithm::BasicLeafIteratorIterator;
+using algorithm::EnumeratedLeafIteratorIterator;
 using algorithm::LeafIteratorIterator;
 
 }  // namespace takram
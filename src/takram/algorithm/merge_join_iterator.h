@@ -0,0 +1,431 @@
+//
+//  takram/algorithm/merge_join_iterator.h
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+#ifndef TAKRAM_ALGORITHM_MERGE_JOIN_ITERATOR_H_
+#define TAKRAM_ALGORITHM_MERGE_JOIN_ITERATOR_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace takram {
+namespace algorithm {
+
+enum class JoinType {
+  kInner,  // Every pair of the left and right rows with equal keys
+  kLeft,   // Same as inner, plus the left rows without any match
+  kSemi    // Each left row that has any match, once
+};
+
+// Extracts the key of a row, which is the first element of tuples such as the
+// values of TupleIteratorIterator, or the row itself otherwise. The keys of
+// temporary rows, which iterators may return by value, are returned by value
+// unless the rows hold references, so that the keys outlive the rows. Custom
+// keys must not return references into temporary rows either.
+struct JoinKey {
+  template <class... Types>
+  decltype(auto) operator()(const std::tuple<Types...>& row) const {
+    return std::get<0>(row);
+  }
+  template <class... Types>
+  std::tuple_element_t<0, std::tuple<Types...>> operator()(
+      std::tuple<Types...>&& row) const {
+    return std::get<0>(std::move(row));
+  }
+  template <class... Types>
+  std::tuple_element_t<0, std::tuple<Types...>> operator()(
+      const std::tuple<Types...>&& row) const {
+    return std::get<0>(row);
+  }
+  template <class T>
+  const T& operator()(const T& row) const {
+    return row;
+  }
+  template <class T,
+            class = std::enable_if_t<!std::is_reference<T>::value>>
+  T operator()(T&& row) const {
+    return std::move(row);
+  }
+};
+
+#pragma mark -
+
+template <class Iterator>
+inline void advance_bounded(
+    Iterator& iterator,
+    typename std::iterator_traits<Iterator>::difference_type n,
+    const Iterator& last,
+    std::random_access_iterator_tag) {
+  iterator += std::min(n, last - iterator);
+}
+
+template <class Iterator>
+inline void advance_bounded(
+    Iterator& iterator,
+    typename std::iterator_traits<Iterator>::difference_type n,
+    const Iterator& last,
+    std::forward_iterator_tag) {
+  for (; n && iterator != last; --n) {
+    ++iterator;
+  }
+}
+
+// Returns the first element in the partitioned range for which the predicate
+// is false, like std::partition_point. The steps from the first element grow
+// exponentially until they pass the partition point, which is then found by
+// binary search, so that the cost is logarithmic in the distance to the
+// result rather than in the size of the range.
+template <class Iterator, class Predicate>
+inline Iterator gallop(Iterator first, Iterator last, Predicate predicate) {
+  using Category = typename std::iterator_traits<Iterator>::iterator_category;
+  if (first == last || !predicate(*first)) {
+    return first;
+  }
+  typename std::iterator_traits<Iterator>::difference_type step{1};
+  for (;; step *= 2) {
+    auto next = first;
+    advance_bounded(next, step, last, Category());
+    if (next == last || !predicate(*next)) {
+      return std::partition_point(std::next(first), next, predicate);
+    }
+    first = next;
+  }
+}
+
+#pragma mark -
+
+// Right row of a left join, which is empty for the left rows without any
+// match. The row is dereferenced only when it is accessed.
+template <class Iterator>
+class JoinMatch final {
+ public:
+  using Reference = typename std::iterator_traits<Iterator>::reference;
+
+ public:
+  JoinMatch(Iterator iterator, bool matched)
+      : iterator_(iterator),
+        matched_(matched) {}
+
+  explicit operator bool() const { return matched_; }
+  Reference operator*() const {
+    assert(matched_);
+    return *iterator_;
+  }
+
+ private:
+  Iterator iterator_;
+  bool matched_;
+};
+
+// Value of MergeJoinIterator, where the right row is a JoinMatch in a left
+// join, and a reference to the row otherwise
+template <class LeftIterator, class RightIterator, JoinType Join>
+using MergeJoinRow = std::pair<
+    typename std::iterator_traits<LeftIterator>::reference,
+    std::conditional_t<
+        Join == JoinType::kLeft, JoinMatch<RightIterator>,
+        typename std::iterator_traits<RightIterator>::reference>>;
+
+#pragma mark -
+
+// Joins two ranges sorted by their keys, and iterates over the matched pairs
+// of the left and right rows. Non-matching runs on either side are skipped
+// by galloping, so that joining a small range with a large one costs about
+// the size of the small one times the logarithm of the gaps between matches.
+template <class LeftIterator, class RightIterator,
+          JoinType Join = JoinType::kInner,
+          class Key = JoinKey, class Compare = std::less<>>
+class MergeJoinIterator final
+    : public std::iterator<
+          std::forward_iterator_tag,
+          MergeJoinRow<LeftIterator, RightIterator, Join>,
+          std::ptrdiff_t,
+          MergeJoinRow<LeftIterator, RightIterator, Join> *,
+          MergeJoinRow<LeftIterator, RightIterator, Join>> {
+ private:
+  using Type = MergeJoinRow<LeftIterator, RightIterator, Join>;
+  using RightValue = typename Type::second_type;
+
+ public:
+  MergeJoinIterator();
+  MergeJoinIterator(LeftIterator left_first, LeftIterator left_last,
+                    RightIterator right_first, RightIterator right_last,
+                    Key key = Key(), Compare compare = Compare());
+
+  // Copy semantics
+  MergeJoinIterator(const MergeJoinIterator&) = default;
+  MergeJoinIterator& operator=(const MergeJoinIterator&) = default;
+
+  // Comparison
+  template <class LeftIter, class RightIter, JoinType J, class K, class C>
+  friend bool operator==(
+      const MergeJoinIterator<LeftIter, RightIter, J, K, C>& lhs,
+      const MergeJoinIterator<LeftIter, RightIter, J, K, C>& rhs);
+  template <class LeftIter, class RightIter, JoinType J, class K, class C>
+  friend bool operator!=(
+      const MergeJoinIterator<LeftIter, RightIter, J, K, C>& lhs,
+      const MergeJoinIterator<LeftIter, RightIter, J, K, C>& rhs);
+
+  // Iterator, where the right row of a left join may be empty
+  Type operator*() const;
+  MergeJoinIterator& operator++();
+  MergeJoinIterator operator++(int);
+
+  // Current rows, where the right one is the end of the right range for the
+  // left rows without any match in a left join
+  LeftIterator left() const { return left_; }
+  RightIterator right() const { return right_; }
+  bool matched() const { return right_ != right_last_; }
+
+ private:
+  void match();
+  RightValue right_value(std::true_type) const;
+  RightValue right_value(std::false_type) const;
+
+ private:
+  LeftIterator left_;
+  LeftIterator left_last_;
+  RightIterator right_;
+  RightIterator group_first_;
+  RightIterator group_last_;
+  RightIterator right_last_;
+  Key key_;
+  Compare compare_;
+};
+
+#pragma mark -
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+    ::MergeJoinIterator()
+    : left_(),
+      left_last_(),
+      right_(),
+      group_first_(),
+      group_last_(),
+      right_last_() {}
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+    ::MergeJoinIterator(LeftIterator left_first, LeftIterator left_last,
+                        RightIterator right_first, RightIterator right_last,
+                        Key key, Compare compare)
+    : left_(left_first),
+      left_last_(left_last),
+      right_(right_last),
+      group_first_(right_first),
+      group_last_(right_first),
+      right_last_(right_last),
+      key_(key),
+      compare_(compare) {
+  match();
+}
+
+// Splits the join of the given ranges into at most the given number of joins
+// over disjoint ranges of keys, that can be iterated in parallel. The splits
+// are placed at about equal intervals on the left range, and are moved to the
+// beginnings of the groups of equal keys so that no group is divided.
+template <JoinType Join = JoinType::kInner,
+          class Key = JoinKey, class Compare = std::less<>,
+          class LeftIterator, class RightIterator>
+inline std::vector<std::pair<
+    MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>,
+    MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>>>
+    partition_merge_join(LeftIterator left_first, LeftIterator left_last,
+                         RightIterator right_first, RightIterator right_last,
+                         std::size_t count,
+                         Key key = Key(), Compare compare = Compare()) {
+  using Iterator =
+      MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>;
+  std::vector<std::pair<Iterator, Iterator>> result;
+  const auto size = std::distance(left_first, left_last);
+  auto left = left_first;
+  auto right = right_first;
+  for (std::size_t i{1}; i <= count; ++i) {
+    auto left_split = left_last;
+    auto right_split = right_last;
+    if (i < count) {
+      const auto candidate = std::next(left_first, size * i / count);
+      if (candidate == left_last) {
+        continue;
+      }
+      decltype(auto) split_key = key(*candidate);
+      left_split = std::partition_point(left, candidate, [&](auto&& row) {
+        return compare(key(row), split_key);
+      });
+      right_split = gallop(right, right_last, [&](auto&& row) {
+        return compare(key(row), split_key);
+      });
+    }
+    if (left_split != left) {
+      result.emplace_back(
+          Iterator(left, left_split, right, right_split, key, compare),
+          Iterator(left_split, left_split, right_split, right_split,
+                   key, compare));
+    }
+    left = left_split;
+    right = right_split;
+  }
+  return result;
+}
+
+#pragma mark Comparison
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline bool operator==(
+    const MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>&
+        lhs,
+    const MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>&
+        rhs) {
+  return lhs.left_ == rhs.left_ &&
+         (lhs.left_ == lhs.left_last_ || lhs.right_ == rhs.right_);
+}
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline bool operator!=(
+    const MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>&
+        lhs,
+    const MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>&
+        rhs) {
+  return !(lhs == rhs);
+}
+
+#pragma mark Iterator
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline typename MergeJoinIterator<
+    LeftIterator, RightIterator, Join, Key, Compare>::Type
+    MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+        ::operator*() const {
+  return Type(*left_, right_value(
+      std::integral_constant<bool, Join == JoinType::kLeft>()));
+}
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline typename MergeJoinIterator<
+    LeftIterator, RightIterator, Join, Key, Compare>::RightValue
+    MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+        ::right_value(std::true_type) const {
+  return RightValue(right_, matched());
+}
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline typename MergeJoinIterator<
+    LeftIterator, RightIterator, Join, Key, Compare>::RightValue
+    MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+        ::right_value(std::false_type) const {
+  assert(matched());
+  return *right_;
+}
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>&
+    MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+        ::operator++() {
+  if (Join != JoinType::kSemi && matched() && ++right_ != group_last_) {
+    return *this;
+  }
+  ++left_;
+  match();
+  return *this;
+}
+
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+    MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+        ::operator++(int) {
+  MergeJoinIterator result(*this);
+  operator++();
+  return result;
+}
+
+// Finds the group of the right rows whose keys are equal to the key of the
+// current left row, skipping the left rows that cannot match unless this is
+// a left join. The group found last is reused for duplicate left keys, and
+// the next search starts from its end because the keys only ascend.
+template <class LeftIterator, class RightIterator,
+          JoinType Join, class Key, class Compare>
+inline void MergeJoinIterator<LeftIterator, RightIterator, Join, Key, Compare>
+    ::match() {
+  while (left_ != left_last_) {
+    decltype(auto) key = key_(*left_);
+    if (group_first_ == right_last_ ||
+        compare_(key, key_(*group_first_))) {
+      group_last_ = group_first_;  // No match for this key
+    } else if (group_first_ == group_last_ ||
+               compare_(key_(*group_first_), key)) {
+      group_first_ = gallop(group_last_, right_last_, [&](auto&& row) {
+        return compare_(key_(row), key);
+      });
+      group_last_ = gallop(group_first_, right_last_, [&](auto&& row) {
+        return !compare_(key, key_(row));
+      });
+    }
+    if (group_first_ != group_last_) {
+      right_ = group_first_;
+      return;
+    }
+    right_ = right_last_;
+    if (Join == JoinType::kLeft) {
+      return;
+    }
+    if (group_first_ == right_last_) {
+      left_ = left_last_;
+      return;
+    }
+    decltype(auto) next = key_(*group_first_);
+    left_ = gallop(left_, left_last_, [&](auto&& row) {
+      return compare_(key_(row), next);
+    });
+  }
+  right_ = right_last_;
+}
+
+}  // namespace algorithm
+
+using algorithm::JoinMatch;
+using algorithm::JoinType;
+using algorithm::MergeJoinIterator;
+
+}  // namespace takram
+
+#endif  // TAKRAM_ALGORITHM_MERGE_JOIN_ITERATOR_H_
@@ -0,0 +1,233 @@
+//
+//  takram/algorithm/permutation_iterator.h
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+#ifndef TAKRAM_ALGORITHM_PERMUTATION_ITERATOR_H_
+#define TAKRAM_ALGORITHM_PERMUTATION_ITERATOR_H_
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#endif
+
+namespace takram {
+namespace algorithm {
+
+template <class IndexIterator, class... Iterators>
+class PermutationIterator final
+    : public std::iterator<
+          std::forward_iterator_tag,
+          std::tuple<typename std::iterator_traits<Iterators>::reference...>> {
+ private:
+  using Type =
+      std::tuple<typename std::iterator_traits<Iterators>::reference...>;
+  using Pointer = Type *;
+
+ public:
+  PermutationIterator();
+  explicit PermutationIterator(IndexIterator index, Iterators... iterators);
+
+  // Copy semantics
+  PermutationIterator(const PermutationIterator&) = default;
+  PermutationIterator& operator=(const PermutationIterator&) = default;
+
+  // Comparison
+  template <class IndexIter, class... Iters>
+  friend bool operator==(const PermutationIterator<IndexIter, Iters...>& lhs,
+                         const PermutationIterator<IndexIter, Iters...>& rhs);
+  template <class IndexIter, class... Iters>
+  friend bool operator!=(const PermutationIterator<IndexIter, Iters...>& lhs,
+                         const PermutationIterator<IndexIter, Iters...>& rhs);
+
+  // Iterator
+  Type operator*() const;
+  Pointer operator->() const { return &operator*(); }
+  PermutationIterator& operator++();
+  PermutationIterator operator++(int);
+
+  // Issues prefetches for the row that the given index refers to
+  void prefetch(IndexIterator index) const;
+
+ private:
+  template <std::size_t... Indexes>
+  Type derefer(std::index_sequence<Indexes...>) const;
+  template <std::size_t... Indexes>
+  void prefetch(IndexIterator index, std::index_sequence<Indexes...>) const;
+
+ private:
+  IndexIterator index_;
+  std::tuple<Iterators...> iterators_;
+};
+
+#pragma mark -
+
+namespace detail {
+
+template <class T>
+inline void prefetch(const T *address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#elif defined(_MSC_VER)
+  _mm_prefetch(reinterpret_cast<const char *>(address), _MM_HINT_T0);
+#endif
+}
+
+}  // namespace detail
+
+// Copies the rows of the given columns that the index range refers to, into
+// the result, which is typically a TupleIteratorIterator. The rows at the
+// given distance ahead are prefetched so that their loads overlap with the
+// copies of the preceding rows.
+template <std::size_t Distance = 16,
+          class IndexIterator, class OutputIterator, class... Iterators>
+inline OutputIterator gather(IndexIterator first, IndexIterator last,
+                             OutputIterator result, Iterators... iterators) {
+  using Iterator = PermutationIterator<IndexIterator, Iterators...>;
+  auto itr = Iterator(first, iterators...);
+  const auto end = Iterator(last, iterators...);
+  auto ahead = first;
+  for (std::size_t i{}; i < Distance && ahead != last; ++i, ++ahead) {
+    itr.prefetch(ahead);
+  }
+  for (; itr != end; ++itr, ++result) {
+    if (ahead != last) {
+      itr.prefetch(ahead++);
+    }
+    *result = *itr;
+  }
+  return result;
+}
+
+// Writes the values into the rows of the given columns that the index range
+// refers to, prefetching the destination rows in the same way as gather.
+template <std::size_t Distance = 16,
+          class IndexIterator, class InputIterator, class... Iterators>
+inline InputIterator scatter(IndexIterator first, IndexIterator last,
+                             InputIterator values, Iterators... iterators) {
+  using Iterator = PermutationIterator<IndexIterator, Iterators...>;
+  auto itr = Iterator(first, iterators...);
+  const auto end = Iterator(last, iterators...);
+  auto ahead = first;
+  for (std::size_t i{}; i < Distance && ahead != last; ++i, ++ahead) {
+    itr.prefetch(ahead);
+  }
+  for (; itr != end; ++itr, ++values) {
+    if (ahead != last) {
+      itr.prefetch(ahead++);
+    }
+    *itr = *values;
+  }
+  return values;
+}
+
+#pragma mark -
+
+template <class IndexIterator, class... Iterators>
+inline PermutationIterator<IndexIterator, Iterators...>::PermutationIterator()
+    : index_() {}
+
+template <class IndexIterator, class... Iterators>
+inline PermutationIterator<IndexIterator, Iterators...>::PermutationIterator(
+    IndexIterator index, Iterators... iterators)
+    : index_(index),
+      iterators_(iterators...) {}
+
+#pragma mark Comparison
+
+template <class IndexIterator, class... Iterators>
+inline bool operator==(
+    const PermutationIterator<IndexIterator, Iterators...>& lhs,
+    const PermutationIterator<IndexIterator, Iterators...>& rhs) {
+  return lhs.index_ == rhs.index_;
+}
+
+template <class IndexIterator, class... Iterators>
+inline bool operator!=(
+    const PermutationIterator<IndexIterator, Iterators...>& lhs,
+    const PermutationIterator<IndexIterator, Iterators...>& rhs) {
+  return !(lhs == rhs);
+}
+
+#pragma mark Iterator
+
+template <class IndexIterator, class... Iterators>
+inline typename PermutationIterator<IndexIterator, Iterators...>::Type
+    PermutationIterator<IndexIterator, Iterators...>::operator*() const {
+  return derefer(std::make_index_sequence<sizeof...(Iterators)>());
+}
+
+template <class IndexIterator, class... Iterators>
+template <std::size_t... Indexes>
+inline typename PermutationIterator<IndexIterator, Iterators...>::Type
+    PermutationIterator<IndexIterator, Iterators...>::derefer(
+        std::index_sequence<Indexes...>) const {
+  return Type(std::get<Indexes>(iterators_)[*index_]...);
+}
+
+template <class IndexIterator, class... Iterators>
+inline PermutationIterator<IndexIterator, Iterators...>&
+    PermutationIterator<IndexIterator, Iterators...>::operator++() {
+  ++index_;
+  return *this;
+}
+
+template <class IndexIterator, class... Iterators>
+inline PermutationIterator<IndexIterator, Iterators...>
+    PermutationIterator<IndexIterator, Iterators...>::operator++(int) {
+  PermutationIterator result(*this);
+  operator++();
+  return result;
+}
+
+#pragma mark Prefetching
+
+template <class IndexIterator, class... Iterators>
+inline void PermutationIterator<IndexIterator, Iterators...>::prefetch(
+    IndexIterator index) const {
+  prefetch(index, std::make_index_sequence<sizeof...(Iterators)>());
+}
+
+template <class IndexIterator, class... Iterators>
+template <std::size_t... Indexes>
+inline void PermutationIterator<IndexIterator, Iterators...>::prefetch(
+    IndexIterator index, std::index_sequence<Indexes...>) const {
+  using Expand = int[];
+  static_cast<void>(Expand{0, (detail::prefetch(
+      std::addressof(std::get<Indexes>(iterators_)[*index])), 0)...});
+}
+
+}  // namespace algorithm
+
+using algorithm::PermutationIterator;
+
+}  // namespace takram
+
+#endif  // TAKRAM_ALGORITHM_PERMUTATION_ITERATOR_H_
@@ -0,0 +1,229 @@
+//
+//  takram/algorithm/stream_leaf_iterator_iterator.h
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+#ifndef TAKRAM_ALGORITHM_STREAM_LEAF_ITERATOR_ITERATOR_H_
+#define TAKRAM_ALGORITHM_STREAM_LEAF_ITERATOR_ITERATOR_H_
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "takram/algorithm/leaf_iterator_iterator.h"
+#include "takram/algorithm/variadic_template.h"
+
+namespace takram {
+namespace algorithm {
+
+// Holds the block the outer iterator currently refers to. Forward iterators
+// that return references keep the referent alive as long as the sequence, so
+// a pointer is enough. Blocks of input iterators may live inside the iterator
+// itself, as in std::istream_iterator, and blocks returned by value are
+// temporaries, so both are moved or copied into storage that is shared
+// between copies of the iterator. The inner iterators of a copy then keep
+// pointing to valid memory after the original is destroyed.
+template <class Iterator,
+          bool = std::is_reference<
+              typename std::iterator_traits<Iterator>::reference>::value &&
+          std::is_base_of<
+              std::forward_iterator_tag,
+              typename std::iterator_traits<Iterator>::iterator_category>
+              ::value>
+class StreamBlock final {
+ public:
+  using Reference = typename std::iterator_traits<Iterator>::reference;
+  using Type = std::remove_reference_t<Reference>;
+
+ public:
+  void reset() { block_ = nullptr; }
+  void reset(Reference block) { block_ = std::addressof(block); }
+  Type& get() const { return *block_; }
+
+ private:
+  Type *block_ = nullptr;
+};
+
+template <class Iterator>
+class StreamBlock<Iterator, false> final {
+ public:
+  using Reference = typename std::iterator_traits<Iterator>::reference;
+  using Type = std::decay_t<Reference>;
+
+ public:
+  void reset() { block_.reset(); }
+  void reset(Reference block) {
+    block_ = std::make_shared<Type>(std::forward<Reference>(block));
+  }
+  Type& get() const { return *block_; }
+
+ private:
+  std::shared_ptr<Type> block_;
+};
+
+#pragma mark -
+
+// Traverses the leafs like LeafIteratorIterator does, but the outermost
+// iterator is only required to be an input iterator. Each outer element is
+// dereferenced exactly once and only the current one is held at a time.
+template <class Iterator, class... RestIterators>
+class StreamLeafIteratorIterator final
+    : public std::iterator<
+          std::input_iterator_tag,
+          typename Last<Iterator, RestIterators...>::Type::value_type,
+          typename Last<Iterator, RestIterators...>::Type::difference_type,
+          typename Last<Iterator, RestIterators...>::Type::pointer,
+          typename Last<Iterator, RestIterators...>::Type::reference> {
+  static_assert(sizeof...(RestIterators), "Requires at least 2 iterators");
+
+ private:
+  using Type = typename Last<Iterator, RestIterators...>::Type::value_type;
+  using Pointer = typename Last<Iterator, RestIterators...>::Type::pointer;
+  using Reference = typename Last<Iterator, RestIterators...>::Type::reference;
+  using RestIterator = LeafIteratorIterator<RestIterators...>;
+
+ public:
+  StreamLeafIteratorIterator();
+  StreamLeafIteratorIterator(Iterator begin, Iterator end);
+
+  // Copy semantics
+  StreamLeafIteratorIterator(const StreamLeafIteratorIterator&) = default;
+  StreamLeafIteratorIterator& operator=(
+      const StreamLeafIteratorIterator&) = default;
+
+  // Comparison
+  template <class Iter, class... RestIters>
+  friend bool operator==(
+      const StreamLeafIteratorIterator<Iter, RestIters...>& lhs,
+      const StreamLeafIteratorIterator<Iter, RestIters...>& rhs);
+  template <class Iter, class... RestIters>
+  friend bool operator!=(
+      const StreamLeafIteratorIterator<Iter, RestIters...>& lhs,
+      const StreamLeafIteratorIterator<Iter, RestIters...>& rhs);
+
+  // Iterator
+  Reference operator*() const;
+  Pointer operator->() const { return &operator*(); }
+  StreamLeafIteratorIterator& operator++();
+  StreamLeafIteratorIterator operator++(int);
+
+ private:
+  void validate();
+
+ private:
+  Iterator current_;
+  Iterator end_;
+  StreamBlock<Iterator> block_;
+  RestIterator rest_;
+  RestIterator rest_end_;
+};
+
+#pragma mark -
+
+template <class Iterator, class... RestIterators>
+inline StreamLeafIteratorIterator<Iterator, RestIterators...>
+    ::StreamLeafIteratorIterator()
+    : current_(),
+      end_() {}
+
+template <class Iterator, class... RestIterators>
+inline StreamLeafIteratorIterator<Iterator, RestIterators...>
+    ::StreamLeafIteratorIterator(Iterator begin, Iterator end)
+    : current_(begin),
+      end_(end) {
+  validate();
+}
+
+#pragma mark Comparison
+
+template <class Iterator, class... RestIterators>
+inline bool operator==(
+    const StreamLeafIteratorIterator<Iterator, RestIterators...>& lhs,
+    const StreamLeafIteratorIterator<Iterator, RestIterators...>& rhs) {
+  return lhs.current_ == rhs.current_ &&
+         (lhs.current_ == lhs.end_ || lhs.rest_ == rhs.rest_);
+}
+
+template <class Iterator, class... RestIterators>
+inline bool operator!=(
+    const StreamLeafIteratorIterator<Iterator, RestIterators...>& lhs,
+    const StreamLeafIteratorIterator<Iterator, RestIterators...>& rhs) {
+  return !(lhs == rhs);
+}
+
+#pragma mark Iterator
+
+template <class Iterator, class... RestIterators>
+inline typename StreamLeafIteratorIterator<Iterator, RestIterators...>
+    ::Reference
+    StreamLeafIteratorIterator<Iterator, RestIterators...>::operator*() const {
+  return *rest_;
+}
+
+template <class Iterator, class... RestIterators>
+inline StreamLeafIteratorIterator<Iterator, RestIterators...>&
+    StreamLeafIteratorIterator<Iterator, RestIterators...>::operator++() {
+  if (++rest_ == rest_end_) {
+    ++current_;
+    validate();
+  }
+  return *this;
+}
+
+template <class Iterator, class... RestIterators>
+inline StreamLeafIteratorIterator<Iterator, RestIterators...>
+    StreamLeafIteratorIterator<Iterator, RestIterators...>::operator++(int) {
+  StreamLeafIteratorIterator result(*this);
+  operator++();
+  return result;
+}
+
+template <class Iterator, class... RestIterators>
+inline void StreamLeafIteratorIterator<Iterator, RestIterators...>::validate() {
+  for (; current_ != end_; ++current_) {
+    // Releases the previous block before the next one is produced, so that
+    // only a single block is held at a time
+    block_.reset();
+    block_.reset(*current_);
+    auto& block = block_.get();
+    rest_ = RestIterator(std::begin(block), std::end(block));
+    rest_end_ = RestIterator(std::end(block), std::end(block));
+    if (rest_ != rest_end_) {
+      return;
+    }
+  }
+  block_.reset();
+  rest_ = RestIterator();
+  rest_end_ = RestIterator();
+}
+
+}  // namespace algorithm
+
+using algorithm::StreamLeafIteratorIterator;
+
+}  // namespace takram
+
+#endif  // TAKRAM_ALGORITHM_STREAM_LEAF_ITERATOR_ITERATOR_H_
@@ -0,0 +1,245 @@
+//
+//  takram/algorithm/stride_iterator.h
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+#ifndef TAKRAM_ALGORITHM_STRIDE_ITERATOR_H_
+#define TAKRAM_ALGORITHM_STRIDE_ITERATOR_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace takram {
+namespace algorithm {
+
+// Random access iterator over the elements of type T that are placed at a
+// constant distance in bytes from each other, such as a component of the
+// vertices in an interleaved buffer.
+template <class T>
+class StrideIterator final
+    : public std::iterator<std::random_access_iterator_tag,
+                           std::remove_const_t<T>,
+                           std::ptrdiff_t, T *, T&> {
+  static_assert(std::is_trivially_copyable<std::remove_const_t<T>>::value,
+                "Requires trivially copyable type");
+
+ private:
+  using Type = std::remove_const_t<T>;
+  using Pointer = T *;
+  using Reference = T&;
+  using Byte = std::conditional_t<std::is_const<T>::value,
+                                  const unsigned char, unsigned char>;
+
+ public:
+  StrideIterator();
+  StrideIterator(Pointer data, std::ptrdiff_t stride);
+
+  // Copy semantics
+  StrideIterator(const StrideIterator&) = default;
+  StrideIterator& operator=(const StrideIterator&) = default;
+
+  // Comparison
+  template <class U>
+  friend bool operator==(const StrideIterator<U>& lhs,
+                         const StrideIterator<U>& rhs);
+  template <class U>
+  friend bool operator!=(const StrideIterator<U>& lhs,
+                         const StrideIterator<U>& rhs);
+  template <class U>
+  friend bool operator<(const StrideIterator<U>& lhs,
+                        const StrideIterator<U>& rhs);
+  template <class U>
+  friend bool operator>(const StrideIterator<U>& lhs,
+                        const StrideIterator<U>& rhs);
+  template <class U>
+  friend bool operator<=(const StrideIterator<U>& lhs,
+                         const StrideIterator<U>& rhs);
+  template <class U>
+  friend bool operator>=(const StrideIterator<U>& lhs,
+                         const StrideIterator<U>& rhs);
+
+  // Iterator
+  Reference operator*() const;
+  Pointer operator->() const { return &operator*(); }
+  Reference operator[](std::ptrdiff_t n) const;
+  StrideIterator& operator++();
+  StrideIterator& operator--();
+  StrideIterator operator++(int);
+  StrideIterator operator--(int);
+  StrideIterator& operator+=(std::ptrdiff_t n);
+  StrideIterator& operator-=(std::ptrdiff_t n);
+  StrideIterator operator+(std::ptrdiff_t n) const;
+  StrideIterator operator-(std::ptrdiff_t n) const;
+  template <class U>
+  friend std::ptrdiff_t operator-(const StrideIterator<U>& lhs,
+                                  const StrideIterator<U>& rhs);
+
+  // Attributes
+  std::ptrdiff_t stride() const { return stride_; }
+
+ private:
+  Byte *data_;
+  std::ptrdiff_t stride_;
+};
+
+#pragma mark -
+
+template <class T>
+inline StrideIterator<T>::StrideIterator() : data_(), stride_() {}
+
+template <class T>
+inline StrideIterator<T>::StrideIterator(Pointer data, std::ptrdiff_t stride)
+    : data_(reinterpret_cast<Byte *>(data)),
+      stride_(stride) {
+  // Dereferencing reinterprets the bytes in place, which requires every
+  // element to be aligned
+  assert(reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0);
+  assert(stride % static_cast<std::ptrdiff_t>(alignof(T)) == 0);
+}
+
+#pragma mark Comparison
+
+template <class T>
+inline bool operator==(const StrideIterator<T>& lhs,
+                       const StrideIterator<T>& rhs) {
+  return lhs.data_ == rhs.data_;
+}
+
+template <class T>
+inline bool operator!=(const StrideIterator<T>& lhs,
+                       const StrideIterator<T>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <class T>
+inline bool operator<(const StrideIterator<T>& lhs,
+                      const StrideIterator<T>& rhs) {
+  return lhs.stride_ < 0 ? rhs.data_ < lhs.data_ : lhs.data_ < rhs.data_;
+}
+
+template <class T>
+inline bool operator>(const StrideIterator<T>& lhs,
+                      const StrideIterator<T>& rhs) {
+  return rhs < lhs;
+}
+
+template <class T>
+inline bool operator<=(const StrideIterator<T>& lhs,
+                       const StrideIterator<T>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <class T>
+inline bool operator>=(const StrideIterator<T>& lhs,
+                       const StrideIterator<T>& rhs) {
+  return !(lhs < rhs);
+}
+
+#pragma mark Iterator
+
+template <class T>
+inline typename StrideIterator<T>::Reference
+    StrideIterator<T>::operator*() const {
+  return *reinterpret_cast<Pointer>(data_);
+}
+
+template <class T>
+inline typename StrideIterator<T>::Reference
+    StrideIterator<T>::operator[](std::ptrdiff_t n) const {
+  return *reinterpret_cast<Pointer>(data_ + n * stride_);
+}
+
+template <class T>
+inline StrideIterator<T>& StrideIterator<T>::operator++() {
+  data_ += stride_;
+  return *this;
+}
+
+template <class T>
+inline StrideIterator<T>& StrideIterator<T>::operator--() {
+  data_ -= stride_;
+  return *this;
+}
+
+template <class T>
+inline StrideIterator<T> StrideIterator<T>::operator++(int) {
+  StrideIterator result(*this);
+  operator++();
+  return result;
+}
+
+template <class T>
+inline StrideIterator<T> StrideIterator<T>::operator--(int) {
+  StrideIterator result(*this);
+  operator--();
+  return result;
+}
+
+template <class T>
+inline StrideIterator<T>& StrideIterator<T>::operator+=(std::ptrdiff_t n) {
+  data_ += n * stride_;
+  return *this;
+}
+
+template <class T>
+inline StrideIterator<T>& StrideIterator<T>::operator-=(std::ptrdiff_t n) {
+  data_ -= n * stride_;
+  return *this;
+}
+
+template <class T>
+inline StrideIterator<T> StrideIterator<T>::operator+(std::ptrdiff_t n) const {
+  return StrideIterator(*this) += n;
+}
+
+template <class T>
+inline StrideIterator<T> StrideIterator<T>::operator-(std::ptrdiff_t n) const {
+  return StrideIterator(*this) -= n;
+}
+
+template <class T>
+inline StrideIterator<T> operator+(std::ptrdiff_t n,
+                                   const StrideIterator<T>& iterator) {
+  return iterator + n;
+}
+
+template <class T>
+inline std::ptrdiff_t operator-(const StrideIterator<T>& lhs,
+                                const StrideIterator<T>& rhs) {
+  assert(lhs.stride_ == rhs.stride_);
+  // Default-constructed iterators have no stride
+  return lhs.stride_ ? (lhs.data_ - rhs.data_) / lhs.stride_ : 0;
+}
+
+}  // namespace algorithm
+
+using algorithm::StrideIterator;
+
+}  // namespace takram
+
+#endif  // TAKRAM_ALGORITHM_STRIDE_ITERATOR_H_
@@ -0,0 +1,376 @@
+//
+//  takram/algorithm/tracked_container.h
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+#ifndef TAKRAM_ALGORITHM_TRACKED_CONTAINER_H_
+#define TAKRAM_ALGORITHM_TRACKED_CONTAINER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "takram/algorithm/leaf_iterator_iterator.h"
+
+namespace takram {
+namespace algorithm {
+
+template <class Container>
+class DirtyIterator;
+
+// Wraps a random access container of subtrees and stamps each subtree with
+// the epoch in which it was last modified. Every modification has to go
+// through this class so that it is recorded. The modifications are also
+// appended to a log ordered by epoch, which lets dirty traversals visit only
+// the subtrees modified since a given epoch, without scanning the others.
+template <class Container>
+class TrackedContainer final {
+ public:
+  using Epoch = std::size_t;
+  using ValueType = typename Container::value_type;
+  using SizeType = typename Container::size_type;
+
+ public:
+  TrackedContainer();
+  explicit TrackedContainer(Container container);
+
+  // Disallow copy semantics
+  TrackedContainer(const TrackedContainer&) = delete;
+  TrackedContainer& operator=(const TrackedContainer&) = delete;
+
+  // Move semantics
+  TrackedContainer(TrackedContainer&&) = default;
+  TrackedContainer& operator=(TrackedContainer&&) = default;
+
+  // Element access
+  const Container& container() const { return container_; }
+  const ValueType& operator[](SizeType index) const;
+  const ValueType& at(SizeType index) const { return container_.at(index); }
+  ValueType& modify(SizeType index);
+
+  // Capacity
+  bool empty() const { return container_.empty(); }
+  SizeType size() const { return container_.size(); }
+
+  // Modifiers
+  void push_back(const ValueType& value);
+  void push_back(ValueType&& value);
+  void resize(SizeType size);
+
+  // Epoch
+  Epoch epoch() const { return epoch_; }
+  Epoch advance() { return ++epoch_; }
+  bool modified(SizeType index, Epoch since) const;
+  void clear(Epoch epoch);
+
+  // Dirty traversal
+  DirtyIterator<Container> dirty_begin(Epoch since) const;
+  DirtyIterator<Container> dirty_end() const;
+  template <class... Iterators>
+  std::pair<LeafIteratorIterator<DirtyIterator<Container>, Iterators...>,
+            LeafIteratorIterator<DirtyIterator<Container>, Iterators...>>
+      dirty_leaves(Epoch since) const;
+
+ private:
+  struct Entry {
+    Epoch epoch;
+    SizeType index;
+  };
+
+  void stamp(SizeType index);
+
+ private:
+  static constexpr Epoch never_ = std::numeric_limits<Epoch>::max();
+
+  Container container_;
+  Epoch epoch_;
+  std::vector<Epoch> versions_;
+  std::vector<std::size_t> entries_;
+  std::deque<Entry> log_;
+  std::size_t offset_;
+
+  friend class DirtyIterator<Container>;
+};
+
+#pragma mark -
+
+// Forward iterator over the subtrees of a TrackedContainer that were modified
+// since an epoch, in the order of their latest modifications.
+template <class Container>
+class DirtyIterator final
+    : public std::iterator<std::forward_iterator_tag,
+                           const typename Container::value_type,
+                           typename Container::difference_type,
+                           const typename Container::value_type *,
+                           const typename Container::value_type&> {
+ private:
+  using Type = const typename Container::value_type;
+  using Pointer = Type *;
+  using Reference = Type&;
+
+ public:
+  DirtyIterator();
+  DirtyIterator(const TrackedContainer<Container> *owner,
+                std::size_t position);
+
+  // Copy semantics
+  DirtyIterator(const DirtyIterator&) = default;
+  DirtyIterator& operator=(const DirtyIterator&) = default;
+
+  // Comparison
+  template <class C>
+  friend bool operator==(const DirtyIterator<C>& lhs,
+                         const DirtyIterator<C>& rhs);
+  template <class C>
+  friend bool operator!=(const DirtyIterator<C>& lhs,
+                         const DirtyIterator<C>& rhs);
+
+  // Iterator
+  Reference operator*() const;
+  Pointer operator->() const { return &operator*(); }
+  DirtyIterator& operator++();
+  DirtyIterator operator++(int);
+
+  // Index of the current subtree in the container
+  typename Container::size_type index() const;
+
+ private:
+  void validate();
+
+ private:
+  const TrackedContainer<Container> *owner_;
+  std::size_t position_;
+};
+
+#pragma mark -
+
+template <class Container>
+constexpr typename TrackedContainer<Container>::Epoch
+    TrackedContainer<Container>::never_;
+
+template <class Container>
+inline TrackedContainer<Container>::TrackedContainer()
+    : epoch_(),
+      offset_() {}
+
+template <class Container>
+inline TrackedContainer<Container>::TrackedContainer(Container container)
+    : container_(std::move(container)),
+      epoch_(),
+      versions_(container_.size(), never_),
+      entries_(container_.size()),
+      offset_() {
+  for (SizeType index{}; index < container_.size(); ++index) {
+    stamp(index);
+  }
+}
+
+#pragma mark Element access
+
+template <class Container>
+inline const typename TrackedContainer<Container>::ValueType&
+    TrackedContainer<Container>::operator[](SizeType index) const {
+  return container_[index];
+}
+
+template <class Container>
+inline typename TrackedContainer<Container>::ValueType&
+    TrackedContainer<Container>::modify(SizeType index) {
+  stamp(index);
+  return container_[index];
+}
+
+#pragma mark Modifiers
+
+template <class Container>
+inline void TrackedContainer<Container>::push_back(const ValueType& value) {
+  container_.push_back(value);
+  versions_.push_back(never_);
+  entries_.emplace_back();
+  stamp(container_.size() - 1);
+}
+
+template <class Container>
+inline void TrackedContainer<Container>::push_back(ValueType&& value) {
+  container_.push_back(std::move(value));
+  versions_.push_back(never_);
+  entries_.emplace_back();
+  stamp(container_.size() - 1);
+}
+
+template <class Container>
+inline void TrackedContainer<Container>::resize(SizeType size) {
+  const auto previous = container_.size();
+  container_.resize(size);
+  versions_.resize(size, never_);
+  entries_.resize(size);
+  for (auto index = previous; index < size; ++index) {
+    stamp(index);
+  }
+}
+
+#pragma mark Epoch
+
+template <class Container>
+inline bool TrackedContainer<Container>::modified(SizeType index,
+                                                  Epoch since) const {
+  return versions_[index] != never_ && versions_[index] >= since;
+}
+
+template <class Container>
+inline void TrackedContainer<Container>::clear(Epoch epoch) {
+  const auto last = std::lower_bound(
+      log_.begin(), log_.end(), epoch, [](const Entry& entry, Epoch epoch) {
+        return entry.epoch < epoch;
+      });
+  offset_ += std::distance(log_.begin(), last);
+  log_.erase(log_.begin(), last);
+}
+
+template <class Container>
+inline void TrackedContainer<Container>::stamp(SizeType index) {
+  if (versions_[index] == epoch_ && entries_[index] >= offset_) {
+    return;  // Already recorded in this epoch
+  }
+  versions_[index] = epoch_;
+  entries_[index] = offset_ + log_.size();
+  log_.push_back(Entry{epoch_, index});
+}
+
+#pragma mark Dirty traversal
+
+template <class Container>
+inline DirtyIterator<Container>
+    TrackedContainer<Container>::dirty_begin(Epoch since) const {
+  const auto first = std::lower_bound(
+      log_.begin(), log_.end(), since, [](const Entry& entry, Epoch epoch) {
+        return entry.epoch < epoch;
+      });
+  return DirtyIterator<Container>(
+      this, offset_ + std::distance(log_.begin(), first));
+}
+
+template <class Container>
+inline DirtyIterator<Container>
+    TrackedContainer<Container>::dirty_end() const {
+  return DirtyIterator<Container>(this, offset_ + log_.size());
+}
+
+template <class Container>
+template <class... Iterators>
+inline std::pair<LeafIteratorIterator<DirtyIterator<Container>, Iterators...>,
+                 LeafIteratorIterator<DirtyIterator<Container>, Iterators...>>
+    TrackedContainer<Container>::dirty_leaves(Epoch since) const {
+  using Iterator = LeafIteratorIterator<DirtyIterator<Container>, Iterators...>;
+  const auto begin = dirty_begin(since);
+  const auto end = dirty_end();
+  return std::make_pair(Iterator(begin, end), Iterator(end, end));
+}
+
+#pragma mark -
+
+template <class Container>
+inline DirtyIterator<Container>::DirtyIterator()
+    : owner_(),
+      position_() {}
+
+template <class Container>
+inline DirtyIterator<Container>::DirtyIterator(
+    const TrackedContainer<Container> *owner, std::size_t position)
+    : owner_(owner),
+      position_(position) {
+  validate();
+}
+
+#pragma mark Comparison
+
+template <class Container>
+inline bool operator==(const DirtyIterator<Container>& lhs,
+                       const DirtyIterator<Container>& rhs) {
+  return lhs.owner_ == rhs.owner_ && lhs.position_ == rhs.position_;
+}
+
+template <class Container>
+inline bool operator!=(const DirtyIterator<Container>& lhs,
+                       const DirtyIterator<Container>& rhs) {
+  return !(lhs == rhs);
+}
+
+#pragma mark Iterator
+
+template <class Container>
+inline typename DirtyIterator<Container>::Reference
+    DirtyIterator<Container>::operator*() const {
+  return owner_->container_[index()];
+}
+
+template <class Container>
+inline typename Container::size_type DirtyIterator<Container>::index() const {
+  return owner_->log_[position_ - owner_->offset_].index;
+}
+
+template <class Container>
+inline DirtyIterator<Container>& DirtyIterator<Container>::operator++() {
+  ++position_;
+  validate();
+  return *this;
+}
+
+template <class Container>
+inline DirtyIterator<Container> DirtyIterator<Container>::operator++(int) {
+  DirtyIterator result(*this);
+  operator++();
+  return result;
+}
+
+template <class Container>
+inline void DirtyIterator<Container>::validate() {
+  if (!owner_) {
+    return;
+  }
+  // Skip the entries superseded by later modifications of the same subtree,
+  // and the ones for subtrees removed by resizing.
+  const auto end = owner_->offset_ + owner_->log_.size();
+  for (; position_ != end; ++position_) {
+    const auto index = owner_->log_[position_ - owner_->offset_].index;
+    if (index < owner_->entries_.size() &&
+        owner_->entries_[index] == position_) {
+      break;
+    }
+  }
+}
+
+}  // namespace algorithm
+
+using algorithm::DirtyIterator;
+using algorithm::TrackedContainer;
+
+}  // namespace takram
+
+#endif  // TAKRAM_ALGORITHM_TRACKED_CONTAINER_H_
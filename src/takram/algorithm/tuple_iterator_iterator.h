@@ -29,29 +29,49 @@
 #define TAKRAM_ALGORITHM_TUPLE_ITERATOR_ITERATOR_H_
 
 #include <cstddef>
+#include <cstdlib>
 #include <iterator>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
+#include "takram/algorithm/variadic_template.h"
+
 namespace takram {
 namespace algorithm {
 
+// Random access when all the internal iterators are, forward otherwise
+template <class... Iterators>
+using TupleIteratorCategory = std::conditional_t<
+    All<std::is_base_of<
+        std::random_access_iterator_tag,
+        typename std::iterator_traits<Iterators>::iterator_category>::value...>
+        ::value,
+    std::random_access_iterator_tag,
+    std::forward_iterator_tag>;
+
+// Holds references to the values of the iterators, which may be pointers
+template <class... Iterators>
+using TupleIteratorReference =
+    std::tuple<typename std::iterator_traits<Iterators>::reference...>;
+
 template <class... Iterators>
 class TupleIteratorIterator final
-    : public std::iterator<std::forward_iterator_tag,
-                           std::tuple<typename Iterators::reference...>> {
+    : public std::iterator<TupleIteratorCategory<Iterators...>,
+                           TupleIteratorReference<Iterators...>,
+                           std::ptrdiff_t,
+                           TupleIteratorReference<Iterators...> *,
+                           TupleIteratorReference<Iterators...>> {
  private:
-  using Type = std::tuple<typename Iterators::reference...>;
+  using Type = TupleIteratorReference<Iterators...>;
   using Pointer = Type *;
-
-  template <std::size_t... Indexes>
-  struct Equals;
-  template <std::size_t... Indexes>
-  struct Increment;
+  using Difference = std::ptrdiff_t;
 
  public:
   TupleIteratorIterator();
   explicit TupleIteratorIterator(Iterators... iterators);
+  template <class... Iters>
+  TupleIteratorIterator(const TupleIteratorIterator<Iters...>& other);
 
   // Copy semantics
   TupleIteratorIterator(const TupleIteratorIterator&) = default;
@@ -64,12 +84,40 @@ class TupleIteratorIterator final
   template <class... Iters>
   friend bool operator!=(const TupleIteratorIterator<Iters...>& lhs,
                          const TupleIteratorIterator<Iters...>& rhs);
+  template <class... Iters>
+  friend bool operator<(const TupleIteratorIterator<Iters...>& lhs,
+                        const TupleIteratorIterator<Iters...>& rhs);
+  template <class... Iters>
+  friend bool operator>(const TupleIteratorIterator<Iters...>& lhs,
+                        const TupleIteratorIterator<Iters...>& rhs);
+  template <class... Iters>
+  friend bool operator<=(const TupleIteratorIterator<Iters...>& lhs,
+                         const TupleIteratorIterator<Iters...>& rhs);
+  template <class... Iters>
+  friend bool operator>=(const TupleIteratorIterator<Iters...>& lhs,
+                         const TupleIteratorIterator<Iters...>& rhs);
 
   // Iterator
   Type operator*() const;
   Pointer operator->() const { return &operator*(); }
   TupleIteratorIterator& operator++();
-  const TupleIteratorIterator& operator++(int);
+  TupleIteratorIterator operator++(int);
+
+  // Bidirectional and random access iterator, available only when all the
+  // internal iterators support them
+  Type operator[](Difference n) const { return *(*this + n); }
+  TupleIteratorIterator& operator--();
+  TupleIteratorIterator operator--(int);
+  TupleIteratorIterator& operator+=(Difference n);
+  TupleIteratorIterator& operator-=(Difference n) { return *this += -n; }
+  TupleIteratorIterator operator+(Difference n) const;
+  TupleIteratorIterator operator-(Difference n) const { return *this + -n; }
+  template <class... Iters>
+  friend std::ptrdiff_t operator-(const TupleIteratorIterator<Iters...>& lhs,
+                                  const TupleIteratorIterator<Iters...>& rhs);
+
+  // Internal iterators
+  const std::tuple<Iterators...>& iterators() const { return iterators_; }
 
  private:
   template <std::size_t... Indexes>
@@ -79,6 +127,13 @@ class TupleIteratorIterator final
   Type derefer(std::index_sequence<Indexes...>) const;
   template <std::size_t... Indexes>
   void increment(std::index_sequence<Indexes...>);
+  template <std::size_t... Indexes>
+  void decrement(std::index_sequence<Indexes...>);
+  template <std::size_t... Indexes>
+  void advance(Difference n, std::index_sequence<Indexes...>);
+  template <std::size_t... Indexes>
+  Difference distance(const TupleIteratorIterator& other,
+                      std::index_sequence<Indexes...>) const;
 
  private:
   std::tuple<Iterators...> iterators_;
@@ -94,6 +149,14 @@ inline TupleIteratorIterator<Iterators...>::TupleIteratorIterator(
     Iterators... iterators)
     : iterators_(iterators...) {}
 
+// Converts the internal iterators, for example from iterators to const
+// iterators.
+template <class... Iterators>
+template <class... Iters>
+inline TupleIteratorIterator<Iterators...>::TupleIteratorIterator(
+    const TupleIteratorIterator<Iters...>& other)
+    : iterators_(other.iterators()) {}
+
 #pragma mark Comparison
 
 template <class... Iterators>
@@ -113,7 +176,63 @@ template <std::size_t... Indexes>
 inline bool TupleIteratorIterator<Iterators...>::equals(
     const TupleIteratorIterator& other,
     std::index_sequence<Indexes...>) const {
-  return Equals<Indexes...>()(*this, other);
+  // Expands the comparisons in order, short-circuiting at the first match
+  bool result{};
+  using Expand = bool[];
+  static_cast<void>(Expand{false, (result = result ||
+      (std::get<Indexes>(iterators_) ==
+       std::get<Indexes>(other.iterators_)))...});
+  return result;
+}
+
+// The distance between TupleIteratorIterators is the one of the internal
+// iterators closest to each other, in the same way as the equality.
+template <class... Iterators>
+inline std::ptrdiff_t operator-(
+    const TupleIteratorIterator<Iterators...>& lhs,
+    const TupleIteratorIterator<Iterators...>& rhs) {
+  return lhs.distance(rhs, std::make_index_sequence<sizeof...(Iterators)>());
+}
+
+template <class... Iterators>
+inline bool operator<(const TupleIteratorIterator<Iterators...>& lhs,
+                      const TupleIteratorIterator<Iterators...>& rhs) {
+  return lhs - rhs < 0;
+}
+
+template <class... Iterators>
+inline bool operator>(const TupleIteratorIterator<Iterators...>& lhs,
+                      const TupleIteratorIterator<Iterators...>& rhs) {
+  return rhs < lhs;
+}
+
+template <class... Iterators>
+inline bool operator<=(const TupleIteratorIterator<Iterators...>& lhs,
+                       const TupleIteratorIterator<Iterators...>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <class... Iterators>
+inline bool operator>=(const TupleIteratorIterator<Iterators...>& lhs,
+                       const TupleIteratorIterator<Iterators...>& rhs) {
+  return !(lhs < rhs);
+}
+
+template <class... Iterators>
+template <std::size_t... Indexes>
+inline typename TupleIteratorIterator<Iterators...>::Difference
+    TupleIteratorIterator<Iterators...>::distance(
+        const TupleIteratorIterator& other,
+        std::index_sequence<Indexes...>) const {
+  const Difference distances[]{(std::get<Indexes>(iterators_) -
+                                std::get<Indexes>(other.iterators_))...};
+  auto result = distances[0];
+  for (const auto distance : distances) {
+    if (std::abs(distance) < std::abs(result)) {
+      result = distance;
+    }
+  }
+  return result;
 }
 
 #pragma mark Iterator
@@ -129,14 +248,15 @@ template <std::size_t... Indexes>
 inline typename TupleIteratorIterator<Iterators...>::Type
     TupleIteratorIterator<Iterators...>::derefer(
         std::index_sequence<Indexes...>) const {
-  return std::tie(*std::get<Indexes>(iterators_)...);
+  return Type(*std::get<Indexes>(iterators_)...);
 }
 
 template <class... Iterators>
 template <std::size_t... Indexes>
 inline void TupleIteratorIterator<Iterators...>::increment(
     std::index_sequence<Indexes...>) {
-  Increment<Indexes...>()(this);
+  using Expand = int[];
+  static_cast<void>(Expand{0, (++std::get<Indexes>(iterators_), 0)...});
 }
 
 template <class... Iterators>
@@ -147,52 +267,62 @@ inline TupleIteratorIterator<Iterators...>&
 }
 
 template <class... Iterators>
-inline const TupleIteratorIterator<Iterators...>&
+inline TupleIteratorIterator<Iterators...>
     TupleIteratorIterator<Iterators...>::operator++(int) {
   TupleIteratorIterator result(*this);
   operator++();
   return result;
 }
 
-#pragma mark -
+template <class... Iterators>
+template <std::size_t... Indexes>
+inline void TupleIteratorIterator<Iterators...>::decrement(
+    std::index_sequence<Indexes...>) {
+  using Expand = int[];
+  static_cast<void>(Expand{0, (--std::get<Indexes>(iterators_), 0)...});
+}
 
 template <class... Iterators>
-template <std::size_t Index, std::size_t... Indexes>
-struct TupleIteratorIterator<Iterators...>::Equals<Index, Indexes...> {
-  using Iterator = TupleIteratorIterator;
-  bool operator()(const Iterator& a, const Iterator& b) {
-    return ((std::get<Index>(a.iterators_) == std::get<Index>(b.iterators_)) ||
-            Equals<Indexes...>()(a, b));
-  }
-};
+template <std::size_t... Indexes>
+inline void TupleIteratorIterator<Iterators...>::advance(
+    Difference n, std::index_sequence<Indexes...>) {
+  using Expand = int[];
+  static_cast<void>(Expand{0, (std::get<Indexes>(iterators_) += n, 0)...});
+}
 
 template <class... Iterators>
-template <std::size_t Index>
-struct TupleIteratorIterator<Iterators...>::Equals<Index> {
-  using Iterator = TupleIteratorIterator;
-  bool operator()(const Iterator& a, const Iterator& b) {
-    return std::get<Index>(a.iterators_) == std::get<Index>(b.iterators_);
-  }
-};
+inline TupleIteratorIterator<Iterators...>&
+    TupleIteratorIterator<Iterators...>::operator--() {
+  decrement(std::make_index_sequence<sizeof...(Iterators)>());
+  return *this;
+}
 
 template <class... Iterators>
-template <std::size_t Index, std::size_t... Indexes>
-struct TupleIteratorIterator<Iterators...>::Increment<Index, Indexes...> {
-  using Iterator = TupleIteratorIterator;
-  void operator()(Iterator *iterator) {
-    ++std::get<Index>(iterator->iterators_);
-    Increment<Indexes...>()(iterator);
-  }
-};
+inline TupleIteratorIterator<Iterators...>
+    TupleIteratorIterator<Iterators...>::operator--(int) {
+  TupleIteratorIterator result(*this);
+  operator--();
+  return result;
+}
 
 template <class... Iterators>
-template <std::size_t Index>
-struct TupleIteratorIterator<Iterators...>::Increment<Index> {
-  using Iterator = TupleIteratorIterator;
-  void operator()(Iterator *iterator) {
-    ++std::get<Index>(iterator->iterators_);
-  }
-};
+inline TupleIteratorIterator<Iterators...>&
+    TupleIteratorIterator<Iterators...>::operator+=(Difference n) {
+  advance(n, std::make_index_sequence<sizeof...(Iterators)>());
+  return *this;
+}
+
+template <class... Iterators>
+inline TupleIteratorIterator<Iterators...>
+    TupleIteratorIterator<Iterators...>::operator+(Difference n) const {
+  return TupleIteratorIterator(*this) += n;
+}
+
+template <class... Iterators>
+inline TupleIteratorIterator<Iterators...> operator+(
+    std::ptrdiff_t n, const TupleIteratorIterator<Iterators...>& iterator) {
+  return iterator + n;
+}
 
 }  // namespace algorithm
 
@@ -28,9 +28,38 @@
 #ifndef TAKRAM_ALGORITHM_VARIADIC_TEMPLATE_H_
 #define TAKRAM_ALGORITHM_VARIADIC_TEMPLATE_H_
 
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
 namespace takram {
 namespace algorithm {
 
+// Selects the type at an index by overload resolution against a class that
+// derives from every pair of an index and a type, instead of recursively
+// instantiating a class for every suffix of the parameter pack.
+template <std::size_t Index, class T>
+struct IndexedType {
+  using Type = T;
+};
+
+template <class Indexes, class... Rest>
+struct IndexedTypes;
+
+template <std::size_t... Indexes, class... Rest>
+struct IndexedTypes<std::index_sequence<Indexes...>, Rest...>
+    : IndexedType<Indexes, Rest>... {};
+
+template <std::size_t Index, class T>
+IndexedType<Index, T> SelectIndexedType(const IndexedType<Index, T>&);
+
+template <std::size_t Index, class... Rest>
+struct At {
+  static_assert(Index < sizeof...(Rest), "Index out of range");
+  using Type = typename decltype(SelectIndexedType<Index>(
+      IndexedTypes<std::index_sequence_for<Rest...>, Rest...>()))::Type;
+};
+
 template <class... Rest>
 struct First;
 
@@ -40,17 +69,14 @@ struct First<T, Rest...> {
 };
 
 template <class... Rest>
-struct Last;
-
-template <class T>
-struct Last<T> {
-  using Type = T;
+struct Last {
+  using Type = typename At<sizeof...(Rest) - 1, Rest...>::Type;
 };
 
-template <class T, class... Rest>
-struct Last<T, Rest...> {
-  using Type = typename Last<Rest...>::Type;
-};
+// Whether all the values are true
+template <bool... Values>
+struct All : std::is_same<std::integer_sequence<bool, true, Values...>,
+                          std::integer_sequence<bool, Values..., true>> {};
 
 }  // namespace algorithm
 }  // namespace takram
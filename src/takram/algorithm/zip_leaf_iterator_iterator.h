@@ -0,0 +1,58 @@
+//
+//  takram/algorithm/zip_leaf_iterator_iterator.h
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#pragma once
+#ifndef TAKRAM_ALGORITHM_ZIP_LEAF_ITERATOR_ITERATOR_H_
+#define TAKRAM_ALGORITHM_ZIP_LEAF_ITERATOR_ITERATOR_H_
+
+#include "takram/algorithm/leaf_iterator_iterator.h"
+#include "takram/algorithm/tuple_iterator_iterator.h"
+
+namespace takram {
+namespace algorithm {
+
+// Traverses the leafs of identically shaped containers in lockstep. Each level
+// is a TupleIteratorIterator over the corresponding level of every container,
+// and the value type is a std::tuple of references to the leafs. Only the
+// first container is inspected to find the ends of the levels, so that the
+// traversal cost does not depend on the number of containers. The shapes are
+// checked by assertions in debug builds.
+template <class... Iterators>
+using ZipLeafIteratorIterator = LeafIteratorIterator<Iterators...>;
+
+// Maintains the indexes of the current leafs at each level as well
+template <class... Iterators>
+using EnumeratedZipLeafIteratorIterator =
+    EnumeratedLeafIteratorIterator<Iterators...>;
+
+}  // namespace algorithm
+
+using algorithm::EnumeratedZipLeafIteratorIterator;
+using algorithm::ZipLeafIteratorIterator;
+
+}  // namespace takram
+
+#endif  // TAKRAM_ALGORITHM_ZIP_LEAF_ITERATOR_ITERATOR_H_
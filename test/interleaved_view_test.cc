@@ -0,0 +1,191 @@
+//
+//  interleaved_view_test.cc
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "takram/algorithm/interleaved_view.h"
+
+namespace takram {
+namespace algorithm {
+
+namespace {
+
+struct Vector3 {
+  float x, y, z;
+};
+
+struct Color {
+  unsigned char r, g, b, a;
+};
+
+struct Vertex {
+  Vector3 position;
+  Color color;
+  float coord[2];
+};
+
+// Converts the columns of rows of the given number of 4-byte components back
+// and forth for every size around the width of the kernels, where some of the
+// columns are integers that must keep their bits
+template <std::size_t Size>
+void ExpectPacked() {
+  using Integer = std::int32_t;
+  for (std::size_t size{}; size < 14; ++size) {
+    std::vector<float> buffer(size * Size);
+    for (std::size_t i{}; i < buffer.size(); ++i) {
+      buffer[i] = i;
+    }
+    std::vector<float> x(size), z(size), w(size);
+    std::vector<Integer> y(size);
+    auto view4 = interleaved_view<float, Integer, float, float>(
+        buffer.data(), size, Size * sizeof(float), 0, 4, 8, 12);
+    auto view3 = interleaved_view<float, Integer, float>(
+        buffer.data(), size, Size * sizeof(float), 0, 4, 8);
+    auto view2 = interleaved_view<float, Integer>(
+        buffer.data(), size, Size * sizeof(float), 0, 4);
+    const auto& constant = buffer;
+    auto constant_view = interleaved_view<float, float>(
+        constant.data(), size, Size * sizeof(float), 0, 4);
+    switch (Size) {
+      case 2:
+        deinterleave(constant_view, x.data(), z.data());
+        for (std::size_t i{}; i < size; ++i) {
+          ASSERT_EQ(z[i], i * 2 + 1);
+        }
+        deinterleave(view2, x.data(), y.data());
+        break;
+      case 3:
+        deinterleave(view3, x.data(), y.data(), z.data());
+        break;
+      case 4:
+        deinterleave(view4, x.data(), y.data(), z.data(), w.data());
+        break;
+    }
+    for (std::size_t i{}; i < size; ++i) {
+      ASSERT_EQ(x[i], i * Size);
+      Integer expected;
+      const float value = i * Size + 1;
+      std::memcpy(&expected, &value, sizeof(expected));
+      ASSERT_EQ(y[i], expected);
+      if (Size > 2) {
+        ASSERT_EQ(z[i], i * Size + 2);
+      }
+      if (Size > 3) {
+        ASSERT_EQ(w[i], i * Size + 3);
+      }
+    }
+    std::fill(buffer.begin(), buffer.end(), -1);
+    const std::vector<float>& other_z = z;
+    switch (Size) {
+      case 2:
+        interleave(view2, x.data(), y.data());
+        break;
+      case 3:
+        interleave(view3, x.data(), y.data(), other_z.data());
+        break;
+      case 4:
+        interleave(view4, x.data(), y.data(), z.data(), w.data());
+        break;
+    }
+    for (std::size_t i{}; i < buffer.size(); ++i) {
+      ASSERT_EQ(buffer[i], i);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(InterleavedViewTest, Traversing) {
+  std::vector<Vertex> vertices(5);
+  auto view = interleaved_view<Vector3, Color, float>(
+      vertices.data(), vertices.size(), sizeof(Vertex),
+      offsetof(Vertex, position), offsetof(Vertex, color),
+      offsetof(Vertex, coord) + sizeof(float));
+  ASSERT_EQ(view.size(), vertices.size());
+  ASSERT_EQ(std::distance(view.begin(), view.end()), vertices.size());
+  int i{};
+  for (auto itr = view.begin(); itr != view.end(); ++itr, ++i) {
+    std::get<0>(*itr).y = i;
+    std::get<1>(*itr).g = i * 2;
+    std::get<2>(*itr) = i * 3;
+  }
+  for (int i{}; i < vertices.size(); ++i) {
+    ASSERT_EQ(vertices[i].position.y, i);
+    ASSERT_EQ(vertices[i].color.g, i * 2);
+    ASSERT_EQ(vertices[i].coord[0], 0);
+    ASSERT_EQ(vertices[i].coord[1], i * 3);
+  }
+  ASSERT_EQ(view.column_end<2>() - view.column_begin<2>(), vertices.size());
+
+  const auto& constant = vertices;
+  auto constant_view = interleaved_view<Color>(
+      constant.data(), constant.size(), sizeof(Vertex),
+      offsetof(Vertex, color));
+  ASSERT_EQ((*std::next(constant_view.column_begin<0>(), 3)).g, 6);
+}
+
+TEST(InterleavedViewTest, Conversion) {
+  std::vector<Vertex> vertices(100);
+  auto view = interleaved_view<Vector3, Color>(
+      vertices.data(), vertices.size(), sizeof(Vertex),
+      offsetof(Vertex, position), offsetof(Vertex, color));
+  std::vector<Vector3> positions(vertices.size());
+  std::vector<Color> colors(vertices.size());
+  for (int i{}; i < vertices.size(); ++i) {
+    positions[i] = Vector3{float(i), float(i * 2), float(i * 3)};
+    colors[i] = Color{1, 2, 3, static_cast<unsigned char>(i)};
+  }
+  interleave(view, positions.begin(), colors.begin());
+  for (int i{}; i < vertices.size(); ++i) {
+    ASSERT_EQ(vertices[i].position.z, i * 3);
+    ASSERT_EQ(vertices[i].color.a, i);
+  }
+  std::vector<Vector3> other_positions(vertices.size());
+  std::vector<Color> other_colors(vertices.size());
+  deinterleave(view, other_positions.begin(), other_colors.begin());
+  for (int i{}; i < vertices.size(); ++i) {
+    ASSERT_EQ(other_positions[i].x, i);
+    ASSERT_EQ(other_positions[i].y, i * 2);
+    ASSERT_EQ(other_colors[i].a, i);
+  }
+}
+
+TEST(InterleavedViewTest, PackedConversion) {
+  ExpectPacked<2>();
+  ExpectPacked<3>();
+  ExpectPacked<4>();
+}
+
+}  // namespace algorithm
+}  // namespace takram
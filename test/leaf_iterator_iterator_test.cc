@@ -25,6 +25,7 @@
 //
 
 #include <iterator>
+#include <list>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -40,6 +41,8 @@ using C = std::vector<int>;
 using B = std::vector<C>;
 using A = std::vector<B>;
 using Iterator = LeafIteratorIterator<A::iterator, B::iterator, C::iterator>;
+using EnumeratedIterator = EnumeratedLeafIteratorIterator<
+    A::iterator, B::iterator, C::iterator>;
 
 }  // namespace
 
@@ -84,6 +87,52 @@ TEST(LeafIteratorIteratorTest, Traversing) {
   }
 }
 
+TEST(LeafIteratorIteratorTest, DefaultConstructed) {
+  {
+    A a;
+    const auto end = Iterator(std::end(a), std::end(a));
+    ASSERT_EQ(Iterator(), Iterator());
+    ASSERT_EQ(Iterator(), end);
+    ASSERT_EQ(end, Iterator());
+  } {
+    A a{{{1}}, {{2}}};
+    auto itr = Iterator(std::begin(a), std::end(a));
+    const auto end = Iterator(std::end(a), std::end(a));
+    ASSERT_NE(Iterator(), itr);
+    ASSERT_NE(itr, Iterator());
+    ASSERT_EQ(Iterator(), end);
+    std::advance(itr, 2);
+    ASSERT_EQ(itr, Iterator());
+  }
+}
+
+TEST(LeafIteratorIteratorTest, Cleared) {
+  A a{{{1, 2}}, {{3}, {4}}, {{5}}};
+  a.at(0).at(0).clear();
+  a.at(1).at(1).clear();
+  a.at(2).at(0).clear();
+  auto itr = Iterator(std::begin(a), std::end(a));
+  const auto end = Iterator(std::end(a), std::end(a));
+  ASSERT_NE(itr, end);
+  ASSERT_EQ(*itr, 3);
+  ASSERT_EQ(++itr, end);
+}
+
+TEST(LeafIteratorIteratorTest, EmptyList) {
+  // Empty lists do not begin at value-initialized iterators
+  using E = std::list<int>;
+  using D = std::vector<E>;
+  using Iterator = LeafIteratorIterator<D::iterator, E::iterator>;
+  D d{{}, {1}, {}, {}, {2, 3}, {}};
+  auto itr = Iterator(std::begin(d), std::end(d));
+  const auto end = Iterator(std::end(d), std::end(d));
+  int j{};
+  for (; itr != end; ++itr) {
+    ASSERT_EQ(*itr, ++j);
+  }
+  ASSERT_EQ(j, 3);
+}
+
 TEST(LeafIteratorIteratorTest, Distance) {
   {
     A a;
@@ -116,5 +165,57 @@ TEST(LeafIteratorIteratorTest, Distance) {
   }
 }
 
+TEST(LeafIteratorIteratorTest, Path) {
+  A a{{}, {{}, {1, 2}, {}}, {{3}}, {{}, {4, 5}}};
+  auto itr = EnumeratedIterator(std::begin(a), std::end(a));
+  const auto end = EnumeratedIterator(std::end(a), std::end(a));
+  std::vector<EnumeratedIterator::Path> paths;
+  for (; itr != end; ++itr) {
+    const auto& path = itr.path();
+    ASSERT_EQ(a.at(path[0]).at(path[1]).at(path[2]), *itr);
+    paths.emplace_back(path);
+  }
+  ASSERT_EQ(paths, std::vector<EnumeratedIterator::Path>({
+      {{1, 1, 0}}, {{1, 1, 1}}, {{2, 0, 0}}, {{3, 1, 0}}, {{3, 1, 1}}}));
+  ASSERT_EQ(itr.path(), EnumeratedIterator::Path({{a.size(), 0, 0}}));
+
+  // Only the enumerating iterators hold the indexes
+  ASSERT_LT(sizeof(Iterator), sizeof(EnumeratedIterator));
+}
+
+TEST(LeafIteratorIteratorTest, Seeking) {
+  A a{{}, {{}, {1, 2}, {}}, {{3}}, {{}, {4, 5}}};
+  const auto end = Iterator(std::end(a), std::end(a));
+  {
+    auto itr = EnumeratedIterator(std::begin(a), std::end(a), {{1, 1, 1}});
+    ASSERT_EQ(*itr, 2);
+    ASSERT_EQ(itr.path(), EnumeratedIterator::Path({{1, 1, 1}}));
+    ++itr;
+    ASSERT_EQ(itr.path(), EnumeratedIterator::Path({{2, 0, 0}}));
+  } {
+    auto itr = Iterator(std::begin(a), std::end(a), {{1, 1, 1}});
+    ASSERT_EQ(*itr, 2);
+    ASSERT_EQ(std::distance(itr, end), 4);
+  } {
+    auto itr = Iterator(std::begin(a), std::end(a), {{3, 1, 1}});
+    ASSERT_EQ(*itr, 5);
+    ASSERT_EQ(++itr, end);
+  } {
+    // Paths not pointing to any leaf move to the next leaf
+    auto itr = EnumeratedIterator(std::begin(a), std::end(a), {{0, 0, 0}});
+    ASSERT_EQ(*itr, 1);
+    ASSERT_EQ(itr.path(), EnumeratedIterator::Path({{1, 1, 0}}));
+    itr = EnumeratedIterator(std::begin(a), std::end(a), {{1, 1, 5}});
+    ASSERT_EQ(*itr, 3);
+    ASSERT_EQ(itr.path(), EnumeratedIterator::Path({{2, 0, 0}}));
+    itr = EnumeratedIterator(std::begin(a), std::end(a), {{1, 9, 0}});
+    ASSERT_EQ(*itr, 3);
+    itr = EnumeratedIterator(std::begin(a), std::end(a), {{3, 1, 2}});
+    ASSERT_EQ(itr, EnumeratedIterator(std::end(a), std::end(a)));
+    itr = EnumeratedIterator(std::begin(a), std::end(a), {{9, 0, 0}});
+    ASSERT_EQ(itr, EnumeratedIterator(std::end(a), std::end(a)));
+  }
+}
+
 }  // namespace algorithm
 }  // namespace takram
@@ -0,0 +1,361 @@
+//
+//  merge_join_iterator_test.cc
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <list>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "takram/algorithm/merge_join_iterator.h"
+#include "takram/algorithm/tuple_iterator_iterator.h"
+
+namespace takram {
+namespace algorithm {
+
+namespace {
+
+using A = std::vector<int>;
+using B = std::list<int>;
+using Pairs = std::vector<std::pair<int, int>>;
+
+A generate(std::size_t size, int range, unsigned int seed) {
+  std::mt19937 engine(seed);
+  std::uniform_int_distribution<int> distribution(0, range);
+  A result(size);
+  for (auto& value : result) {
+    value = distribution(engine);
+  }
+  std::sort(std::begin(result), std::end(result));
+  return result;
+}
+
+// Nested loop join of the indexes of the rows, where the right index of
+// unmatched rows is -1
+template <JoinType Join>
+Pairs join(const A& a, const A& b) {
+  Pairs result;
+  for (int i{}; i < a.size(); ++i) {
+    bool matched{};
+    for (int j{}; j < b.size(); ++j) {
+      if (a[i] == b[j]) {
+        matched = true;
+        result.emplace_back(i, j);
+        if (Join == JoinType::kSemi) {
+          break;
+        }
+      }
+    }
+    if (!matched && Join == JoinType::kLeft) {
+      result.emplace_back(i, -1);
+    }
+  }
+  return result;
+}
+
+int index(const int& row, const A& b) {
+  return std::distance(&b.front(), &row);
+}
+
+template <class Iterator>
+int index(const JoinMatch<Iterator>& row, const A& b) {
+  return row ? index(*row, b) : -1;
+}
+
+template <JoinType Join, class Iterator>
+Pairs collect(Iterator first, Iterator last, const A& a, const A& b) {
+  Pairs result;
+  for (; first != last; ++first) {
+    const auto row = *first;
+    result.emplace_back(index(row.first, a), index(row.second, b));
+  }
+  return result;
+}
+
+// Random access iterator over the multiples of a step, which returns the
+// values by value as if they were computed on the fly
+class Counter final
+    : public std::iterator<std::random_access_iterator_tag,
+                           long, std::ptrdiff_t, const long *, long> {
+ public:
+  Counter() : index_(), step_() {}
+  Counter(std::ptrdiff_t index, long step) : index_(index), step_(step) {}
+
+  friend bool operator==(const Counter& lhs, const Counter& rhs) {
+    return lhs.index_ == rhs.index_;
+  }
+  friend bool operator!=(const Counter& lhs, const Counter& rhs) {
+    return !(lhs == rhs);
+  }
+  friend bool operator<(const Counter& lhs, const Counter& rhs) {
+    return lhs.index_ < rhs.index_;
+  }
+  friend std::ptrdiff_t operator-(const Counter& lhs, const Counter& rhs) {
+    return lhs.index_ - rhs.index_;
+  }
+
+  long operator*() const { return index_ * step_; }
+  long operator[](std::ptrdiff_t n) const { return *(*this + n); }
+  Counter& operator++() { ++index_; return *this; }
+  Counter& operator--() { --index_; return *this; }
+  Counter operator++(int) { return Counter(index_++, step_); }
+  Counter operator--(int) { return Counter(index_--, step_); }
+  Counter& operator+=(std::ptrdiff_t n) { index_ += n; return *this; }
+  Counter& operator-=(std::ptrdiff_t n) { index_ -= n; return *this; }
+  Counter operator+(std::ptrdiff_t n) const { return Counter(*this) += n; }
+  Counter operator-(std::ptrdiff_t n) const { return Counter(*this) -= n; }
+
+ private:
+  std::ptrdiff_t index_;
+  long step_;
+};
+
+template <JoinType Join>
+void test(const A& a, const A& b) {
+  using Iterator = MergeJoinIterator<A::const_iterator, A::const_iterator,
+                                     Join>;
+  const auto itr = Iterator(std::begin(a), std::end(a),
+                            std::begin(b), std::end(b));
+  const auto end = Iterator(std::end(a), std::end(a),
+                            std::end(b), std::end(b));
+  ASSERT_EQ(collect<Join>(itr, end, a, b), join<Join>(a, b));
+}
+
+}  // namespace
+
+TEST(MergeJoinIteratorTest, Gallop) {
+  A a(100);
+  for (int i{}; i < a.size(); ++i) {
+    a[i] = i / 3;
+  }
+  for (int i{-1}; i <= 34; ++i) {
+    const auto expected = std::lower_bound(std::begin(a), std::end(a), i);
+    ASSERT_EQ(gallop(std::begin(a), std::end(a), [i](int value) {
+      return value < i;
+    }), expected);
+  }
+  B b(std::begin(a), std::end(a));
+  for (int i{-1}; i <= 34; ++i) {
+    const auto expected = std::lower_bound(std::begin(b), std::end(b), i);
+    ASSERT_EQ(gallop(std::begin(b), std::end(b), [i](int value) {
+      return value < i;
+    }), expected);
+  }
+}
+
+TEST(MergeJoinIteratorTest, Traversing) {
+  {
+    A a;
+    A b;
+    test<JoinType::kInner>(a, b);
+    test<JoinType::kLeft>(a, b);
+    test<JoinType::kSemi>(a, b);
+  } {
+    A a{1, 2, 3};
+    A b;
+    test<JoinType::kInner>(a, b);
+    test<JoinType::kLeft>(a, b);
+    test<JoinType::kSemi>(a, b);
+  } {
+    A a;
+    A b{1, 2, 3};
+    test<JoinType::kInner>(a, b);
+    test<JoinType::kLeft>(a, b);
+    test<JoinType::kSemi>(a, b);
+  } {
+    A a{0, 1, 1, 2, 4, 4, 4, 7, 9};
+    A b{1, 1, 1, 3, 4, 4, 5, 6, 7, 7, 10};
+    test<JoinType::kInner>(a, b);
+    test<JoinType::kLeft>(a, b);
+    test<JoinType::kSemi>(a, b);
+    test<JoinType::kInner>(b, a);
+    test<JoinType::kLeft>(b, a);
+    test<JoinType::kSemi>(b, a);
+  }
+  for (unsigned int seed{}; seed < 20; ++seed) {
+    const auto a = generate(50 + seed, 100, seed);
+    const auto b = generate(2000, 1000, seed + 100);
+    test<JoinType::kInner>(a, b);
+    test<JoinType::kLeft>(a, b);
+    test<JoinType::kSemi>(a, b);
+    test<JoinType::kInner>(b, a);
+    test<JoinType::kLeft>(b, a);
+    test<JoinType::kSemi>(b, a);
+  }
+}
+
+TEST(MergeJoinIteratorTest, ForwardIterator) {
+  A a{0, 1, 1, 2, 4, 4, 4, 7, 9};
+  B b{1, 1, 1, 3, 4, 4, 5, 6, 7, 7, 10};
+  using Iterator = MergeJoinIterator<A::iterator, B::iterator>;
+  auto itr = Iterator(std::begin(a), std::end(a), std::begin(b), std::end(b));
+  const auto end = Iterator(std::end(a), std::end(a), std::end(b), std::end(b));
+  Pairs result;
+  for (; itr != end; ++itr) {
+    result.emplace_back((*itr).first, (*itr).second);
+  }
+  const Pairs expected{
+    {1, 1}, {1, 1}, {1, 1}, {1, 1}, {1, 1}, {1, 1},
+    {4, 4}, {4, 4}, {4, 4}, {4, 4}, {4, 4}, {4, 4},
+    {7, 7}, {7, 7}};
+  ASSERT_EQ(result, expected);
+}
+
+TEST(MergeJoinIteratorTest, Unmatched) {
+  A a{1, 2, 3};
+  A b{2};
+  using Iterator = MergeJoinIterator<A::iterator, A::iterator,
+                                     JoinType::kLeft>;
+  auto itr = Iterator(std::begin(a), std::end(a), std::begin(b), std::end(b));
+  const auto unmatched = *itr;
+  ASSERT_EQ(&unmatched.first, &a[0]);
+  ASSERT_FALSE(unmatched.second);
+  EXPECT_DEBUG_DEATH(*unmatched.second, "");
+  const auto matched = *++itr;
+  ASSERT_EQ(&matched.first, &a[1]);
+  ASSERT_TRUE(matched.second);
+  ASSERT_EQ(&*matched.second, &b[0]);
+  ASSERT_FALSE((*++itr).second);
+}
+
+TEST(MergeJoinIteratorTest, Zipped) {
+  std::vector<int> a_keys{1, 2, 2, 5, 8};
+  std::vector<float> a_values{1.0, 2.0, 2.5, 5.0, 8.0};
+  std::vector<int> b_keys{0, 2, 3, 5, 5, 9};
+  std::vector<char> b_values{'a', 'b', 'c', 'd', 'e', 'f'};
+  using Left = TupleIteratorIterator<std::vector<int>::iterator,
+                                     std::vector<float>::iterator>;
+  using Right = TupleIteratorIterator<std::vector<int>::iterator,
+                                      std::vector<char>::iterator>;
+  using Iterator = MergeJoinIterator<Left, Right, JoinType::kLeft>;
+  const Left left_first(std::begin(a_keys), std::begin(a_values));
+  const Left left_last(std::end(a_keys), std::end(a_values));
+  const Right right_first(std::begin(b_keys), std::begin(b_values));
+  const Right right_last(std::end(b_keys), std::end(b_values));
+  auto itr = Iterator(left_first, left_last, right_first, right_last);
+  const auto end = Iterator(left_last, left_last, right_last, right_last);
+  std::vector<std::pair<float, char>> result;
+  for (; itr != end; ++itr) {
+    const auto row = *itr;
+    const float value = std::abs(std::get<1>(row.first));
+    if (row.second) {
+      result.emplace_back(value, std::get<1>(*row.second));
+      std::get<1>(row.first) = -value;
+    } else {
+      result.emplace_back(value, '\0');
+    }
+  }
+  const std::vector<std::pair<float, char>> expected{
+    {1.0, '\0'}, {2.0, 'b'}, {2.5, 'b'}, {5.0, 'd'}, {5.0, 'e'}, {8.0, '\0'}};
+  ASSERT_EQ(result, expected);
+  const std::vector<float> negated{1.0, -2.0, -2.5, -5.0, 8.0};
+  ASSERT_EQ(a_values, negated);
+}
+
+TEST(MergeJoinIteratorTest, Temporary) {
+  // The keys of rows returned by value must outlive the rows
+  const auto left_first = Counter(0, 3);
+  const auto left_last = Counter(100, 3);
+  const auto right_first = Counter(0, 5);
+  const auto right_last = Counter(100, 5);
+  std::vector<std::pair<long, long>> expected;
+  for (long i{}; i < 300; i += 15) {
+    expected.emplace_back(i, i);
+  }
+  {
+    std::vector<std::pair<long, long>> result;
+    for (const auto& partition : partition_merge_join(
+             left_first, left_last, right_first, right_last, 3)) {
+      for (auto itr = partition.first; itr != partition.second; ++itr) {
+        result.emplace_back(*itr);
+      }
+    }
+    ASSERT_EQ(result, expected);
+  } {
+    using Zipped = TupleIteratorIterator<Counter, Counter>;
+    using Iterator = MergeJoinIterator<Zipped, Zipped>;
+    auto itr = Iterator(Zipped(left_first, left_first),
+                        Zipped(left_last, left_last),
+                        Zipped(right_first, right_first),
+                        Zipped(right_last, right_last));
+    const auto end = Iterator(Zipped(left_last, left_last),
+                              Zipped(left_last, left_last),
+                              Zipped(right_last, right_last),
+                              Zipped(right_last, right_last));
+    std::vector<std::pair<long, long>> result;
+    for (; itr != end; ++itr) {
+      result.emplace_back(std::get<1>((*itr).first),
+                          std::get<1>((*itr).second));
+    }
+    ASSERT_EQ(result, expected);
+  }
+}
+
+TEST(MergeJoinIteratorTest, Partitioning) {
+  const auto a = generate(5000, 300, 1);
+  const auto b = generate(3000, 400, 2);
+  const auto expected = join<JoinType::kLeft>(a, b);
+  for (std::size_t count{1}; count <= 8; ++count) {
+    const auto partitions = partition_merge_join<JoinType::kLeft>(
+        std::begin(a), std::end(a), std::begin(b), std::end(b), count);
+    ASSERT_LE(partitions.size(), count);
+    std::vector<Pairs> results(partitions.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i{}; i < partitions.size(); ++i) {
+      threads.emplace_back([&, i]() {
+        results[i] = collect<JoinType::kLeft>(
+            partitions[i].first, partitions[i].second, a, b);
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    Pairs result;
+    for (const auto& partition : results) {
+      ASSERT_FALSE(partition.empty());
+      result.insert(std::end(result), std::begin(partition),
+                    std::end(partition));
+    }
+    ASSERT_EQ(result, expected);
+  }
+  {
+    // A single group of equal keys cannot be divided
+    const A a(100, 1);
+    const A b(10, 1);
+    const auto partitions = partition_merge_join(
+        std::begin(a), std::end(a), std::begin(b), std::end(b), 4);
+    ASSERT_EQ(partitions.size(), 1);
+  }
+}
+
+}  // namespace algorithm
+}  // namespace takram
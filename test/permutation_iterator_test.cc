@@ -0,0 +1,155 @@
+//
+//  permutation_iterator_test.cc
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "takram/algorithm/permutation_iterator.h"
+#include "takram/algorithm/tuple_iterator_iterator.h"
+
+namespace takram {
+namespace algorithm {
+
+namespace {
+
+using I = std::vector<std::size_t>;
+using A = std::vector<int>;
+using B = std::vector<double>;
+using Iterator = PermutationIterator<I::iterator, A::iterator, B::iterator>;
+
+}  // namespace
+
+TEST(PermutationIteratorTest, Traversing) {
+  A a(100);
+  B b(100);
+  std::iota(a.begin(), a.end(), 0);
+  std::iota(b.begin(), b.end(), 0);
+  I indexes(a.size());
+  std::iota(indexes.rbegin(), indexes.rend(), 0);
+  auto itr = Iterator(std::begin(indexes), std::begin(a), std::begin(b));
+  const auto end = Iterator(std::end(indexes), std::begin(a), std::begin(b));
+  ASSERT_NE(itr, end);
+  ASSERT_EQ(std::distance(itr, end), indexes.size());
+  int j = a.size();
+  for (; itr != end; ++itr) {
+    --j;
+    ASSERT_EQ(std::get<0>(*itr), j);
+    ASSERT_EQ(std::get<1>(*itr), j);
+  }
+  ASSERT_EQ(itr, end);
+}
+
+TEST(PermutationIteratorTest, Gather) {
+  for (std::size_t size : {0, 1, 5, 1000}) {
+    A a(size);
+    B b(size);
+    std::iota(a.begin(), a.end(), 0);
+    std::iota(b.begin(), b.end(), 0);
+    I indexes(size);
+    std::iota(indexes.begin(), indexes.end(), 0);
+    std::reverse(indexes.begin(), indexes.end());
+    A c(size);
+    B d(size);
+    using Result = TupleIteratorIterator<A::iterator, B::iterator>;
+    const auto result = gather(
+        std::begin(indexes), std::end(indexes),
+        Result(std::begin(c), std::begin(d)),
+        std::begin(a), std::begin(b));
+    ASSERT_EQ(result, Result(std::end(c), std::end(d)));
+    for (std::size_t i{}; i < size; ++i) {
+      ASSERT_EQ(c[i], a[indexes[i]]);
+      ASSERT_EQ(d[i], b[indexes[i]]);
+    }
+  }
+}
+
+TEST(PermutationIteratorTest, Scatter) {
+  for (std::size_t size : {0, 1, 5, 1000}) {
+    A a(size);
+    B b(size);
+    std::iota(a.begin(), a.end(), 0);
+    std::iota(b.begin(), b.end(), 0);
+    I indexes(size);
+    for (std::size_t i{}; i < size; ++i) {
+      indexes[i] = (i * 7) % size;
+    }
+    A c(size);
+    B d(size);
+    using Values = TupleIteratorIterator<A::iterator, B::iterator>;
+    const auto values = scatter<4>(
+        std::begin(indexes), std::end(indexes),
+        Values(std::begin(a), std::begin(b)),
+        std::begin(c), std::begin(d));
+    ASSERT_EQ(values, Values(std::end(a), std::end(b)));
+    for (std::size_t i{}; i < size; ++i) {
+      ASSERT_EQ(c[indexes[i]], a[i]);
+      ASSERT_EQ(d[indexes[i]], b[i]);
+    }
+  }
+}
+
+TEST(PermutationIteratorTest, Pointer) {
+  // Raw pointers are the usual type of columns in large passes
+  const std::size_t size{100};
+  A a(size);
+  B b(size);
+  std::iota(a.begin(), a.end(), 0);
+  std::iota(b.begin(), b.end(), 0);
+  I indexes(size);
+  for (std::size_t i{}; i < size; ++i) {
+    indexes[i] = (i * 7) % size;
+  }
+  A c(size);
+  B d(size);
+  using Columns = TupleIteratorIterator<int *, double *>;
+  const auto result = gather(
+      std::begin(indexes), std::end(indexes),
+      Columns(c.data(), d.data()), a.data(), b.data());
+  ASSERT_EQ(result, Columns(c.data() + size, d.data() + size));
+  for (std::size_t i{}; i < size; ++i) {
+    ASSERT_EQ(c[i], a[indexes[i]]);
+    ASSERT_EQ(d[i], b[indexes[i]]);
+  }
+  std::fill(a.begin(), a.end(), 0);
+  std::fill(b.begin(), b.end(), 0);
+  scatter(std::begin(indexes), std::end(indexes),
+          Columns(c.data(), d.data()), a.data(), b.data());
+  for (std::size_t i{}; i < size; ++i) {
+    ASSERT_EQ(a[i], i);
+    ASSERT_EQ(b[i], i);
+  }
+  auto itr = PermutationIterator<I::iterator, int *>(
+      std::begin(indexes), a.data());
+  ASSERT_EQ(std::get<0>(*++itr), 7);
+}
+
+}  // namespace algorithm
+}  // namespace takram
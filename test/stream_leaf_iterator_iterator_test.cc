@@ -0,0 +1,372 @@
+//
+//  stream_leaf_iterator_iterator_test.cc
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "takram/algorithm/stream_leaf_iterator_iterator.h"
+
+namespace takram {
+namespace algorithm {
+
+namespace {
+
+using C = std::vector<int>;
+using B = std::vector<C>;
+using A = std::vector<B>;
+
+// Single-pass source that decodes a block from each element of a container
+// and returns it by value, counting how many times it was dereferenced.
+class Generator final
+    : public std::iterator<std::input_iterator_tag, B, std::ptrdiff_t,
+                           const B *, B> {
+ public:
+  Generator() : current_(), count_() {}
+  Generator(A::const_iterator current, int *count)
+      : current_(current),
+        count_(count) {}
+  bool operator==(const Generator& other) const {
+    return current_ == other.current_;
+  }
+  bool operator!=(const Generator& other) const { return !(*this == other); }
+  B operator*() const {
+    ++*count_;
+    return *current_;
+  }
+  Generator& operator++() {
+    ++current_;
+    return *this;
+  }
+
+ private:
+  A::const_iterator current_;
+  int *count_;
+};
+
+// Decodes blocks from a stream. Copies share the position in the stream, and
+// every dereference reads the next block from it, so that the source can be
+// traversed only once and each element can be dereferenced only once.
+class Decoder final
+    : public std::iterator<std::input_iterator_tag, B, std::ptrdiff_t,
+                           const B *, B> {
+ public:
+  Decoder() = default;
+  Decoder(std::istream *stream, int *count)
+      : state_(std::make_shared<State>()),
+        count_(count) {
+    state_->stream = stream;
+    *stream >> state_->remaining;
+  }
+  bool operator==(const Decoder& other) const {
+    return remaining() == other.remaining();
+  }
+  bool operator!=(const Decoder& other) const { return !(*this == other); }
+  B operator*() const {
+    ++*count_;
+    return decode();
+  }
+  Decoder& operator++() {
+    if (!state_->decoded) {
+      decode();
+    }
+    state_->decoded = false;
+    --state_->remaining;
+    return *this;
+  }
+
+ private:
+  struct State {
+    std::istream *stream;
+    std::size_t remaining;
+    bool decoded;
+  };
+
+  std::size_t remaining() const { return state_ ? state_->remaining : 0; }
+
+  B decode() const {
+    auto& stream = *state_->stream;
+    std::size_t size{};
+    stream >> size;
+    B block(size);
+    for (auto& values : block) {
+      stream >> size;
+      values.resize(size);
+      for (auto& value : values) {
+        stream >> value;
+      }
+    }
+    state_->decoded = true;
+    return block;
+  }
+
+ private:
+  std::shared_ptr<State> state_;
+  int *count_ = nullptr;
+};
+
+std::string encode(const A& a) {
+  std::ostringstream stream;
+  stream << a.size();
+  for (const auto& block : a) {
+    stream << " " << block.size();
+    for (const auto& values : block) {
+      stream << " " << values.size();
+      for (const auto& value : values) {
+        stream << " " << value;
+      }
+    }
+  }
+  return stream.str();
+}
+
+// Block of values that counts how many values are held by all the records,
+// where moved records hand over their values
+class Record final : public C {
+ public:
+  Record() = default;
+  Record(const Record& other) : C(other) { add(size()); }
+  Record(Record&& other) : C(std::move(other)) {}
+  Record& operator=(const Record& other) {
+    add(other.size() - size());
+    C::operator=(other);
+    return *this;
+  }
+  Record& operator=(Record&& other) {
+    add(-size());
+    C::operator=(std::move(other));
+    return *this;
+  }
+  ~Record() { add(-size()); }
+
+  void read(std::istream& stream, std::size_t size) {
+    add(size - this->size());
+    resize(size);
+    for (auto& value : *this) {
+      stream >> value;
+    }
+  }
+
+  static std::ptrdiff_t live;
+  static std::ptrdiff_t peak;
+
+ private:
+  static void add(std::ptrdiff_t size) {
+    live += size;
+    peak = std::max(peak, live);
+  }
+};
+
+std::ptrdiff_t Record::live{};
+std::ptrdiff_t Record::peak{};
+
+std::istream& operator>>(std::istream& stream, Record& record) {
+  std::size_t size{};
+  if (stream >> size) {
+    record.read(stream, size);
+  }
+  return stream;
+}
+
+// Reads the given number of records from a stream, returning them by value
+class Reader final
+    : public std::iterator<std::input_iterator_tag, Record, std::ptrdiff_t,
+                           const Record *, Record> {
+ public:
+  Reader() : stream_(), remaining_() {}
+  Reader(std::istream *stream, std::size_t remaining)
+      : stream_(stream),
+        remaining_(remaining) {}
+  bool operator==(const Reader& other) const {
+    return remaining_ == other.remaining_;
+  }
+  bool operator!=(const Reader& other) const { return !(*this == other); }
+  Record operator*() const {
+    Record record;
+    *stream_ >> record;
+    return record;
+  }
+  Reader& operator++() {
+    --remaining_;
+    return *this;
+  }
+
+ private:
+  std::istream *stream_;
+  std::size_t remaining_;
+};
+
+using Iterator = StreamLeafIteratorIterator<
+    Generator, B::iterator, C::iterator>;
+
+}  // namespace
+
+TEST(StreamLeafIteratorIteratorTest, Traversing) {
+  {
+    A a;
+    int count{};
+    auto itr = Iterator(Generator(std::begin(a), &count),
+                        Generator(std::end(a), &count));
+    const auto end = Iterator(Generator(std::end(a), &count),
+                              Generator(std::end(a), &count));
+    ASSERT_EQ(itr, end);
+    ASSERT_EQ(count, 0);
+  } {
+    int i{};
+    A a{{{++i, ++i}, {++i, ++i}}, {{++i, ++i}, {++i, ++i}}};
+    int count{};
+    auto itr = Iterator(Generator(std::begin(a), &count),
+                        Generator(std::end(a), &count));
+    const auto end = Iterator(Generator(std::end(a), &count),
+                              Generator(std::end(a), &count));
+    ASSERT_NE(itr, end);
+    int j{};
+    for (; itr != end; ++itr) {
+      ASSERT_EQ(*itr, ++j);
+    }
+    ASSERT_EQ(itr, end);
+    ASSERT_EQ(j, i);
+    ASSERT_EQ(count, a.size());
+  } {
+    int i{};
+    A a{{}, {{}, {++i}, {}}, {}, {{}, {++i}, {}}, {}};
+    int count{};
+    auto itr = Iterator(Generator(std::begin(a), &count),
+                        Generator(std::end(a), &count));
+    const auto end = Iterator(Generator(std::end(a), &count),
+                              Generator(std::end(a), &count));
+    ASSERT_NE(itr, end);
+    int j{};
+    for (; itr != end; ++itr) {
+      ASSERT_EQ(*itr, ++j);
+    }
+    ASSERT_EQ(itr, end);
+    ASSERT_EQ(j, i);
+    ASSERT_EQ(count, a.size());
+  } {
+    A a{{{}}, {{}}};
+    int count{};
+    auto itr = Iterator(Generator(std::begin(a), &count),
+                        Generator(std::end(a), &count));
+    const auto end = Iterator(Generator(std::end(a), &count),
+                              Generator(std::end(a), &count));
+    ASSERT_EQ(itr, end);
+    ASSERT_EQ(count, a.size());
+  }
+}
+
+TEST(StreamLeafIteratorIteratorTest, SinglePass) {
+  using Iterator = StreamLeafIteratorIterator<
+      Decoder, B::iterator, C::iterator>;
+  {
+    std::istringstream stream(encode(A()));
+    int count{};
+    auto itr = Iterator(Decoder(&stream, &count), Decoder());
+    const auto end = Iterator(Decoder(), Decoder());
+    ASSERT_EQ(itr, end);
+    ASSERT_EQ(count, 0);
+  } {
+    int i{};
+    A a{{}, {{}, {++i, ++i}, {}}, {{}}, {{++i}}, {{}, {++i, ++i}}, {}};
+    std::istringstream stream(encode(a));
+    int count{};
+    auto itr = Iterator(Decoder(&stream, &count), Decoder());
+    const auto end = Iterator(Decoder(), Decoder());
+    ASSERT_NE(itr, end);
+    int j{};
+    for (; itr != end; ++itr) {
+      ASSERT_EQ(*itr, ++j);
+    }
+    ASSERT_EQ(itr, end);
+    ASSERT_EQ(j, i);
+    ASSERT_EQ(count, a.size());
+    ASSERT_TRUE((stream >> std::ws).eof());
+  }
+}
+
+TEST(StreamLeafIteratorIteratorTest, Reference) {
+  B b{{}, {1, 2}, {}, {3}, {4, 5}};
+  using Iterator = StreamLeafIteratorIterator<
+      std::move_iterator<B::iterator>, C::iterator>;
+  auto itr = Iterator(std::make_move_iterator(std::begin(b)),
+                      std::make_move_iterator(std::end(b)));
+  const auto end = Iterator(std::make_move_iterator(std::end(b)),
+                            std::make_move_iterator(std::end(b)));
+  C c;
+  std::copy(itr, end, std::back_inserter(c));
+  ASSERT_EQ(c, C({1, 2, 3, 4, 5}));
+}
+
+TEST(StreamLeafIteratorIteratorTest, StreamIterator) {
+  // std::istream_iterator returns references to the record it holds, which
+  // must not be referred to by the copies of the iterator
+  using Input = std::istream_iterator<Record>;
+  using Iterator = StreamLeafIteratorIterator<Input, C::const_iterator>;
+  const auto make = [](std::istream& stream) {
+    return Iterator(Input(stream), Input());
+  };
+  const auto end = Iterator(Input(), Input());
+  {
+    std::istringstream stream("0 2 1 2 0 1 3 2 4 5");
+    C c;
+    for (auto itr = make(stream); itr != end; ++itr) {
+      c.push_back(*itr);
+    }
+    ASSERT_EQ(c, C({1, 2, 3, 4, 5}));
+  } {
+    std::istringstream stream("2 1 2 0 3 3 4 5 1 6");
+    auto itr = std::find(make(stream), end, 4);
+    int sum{};
+    for (; itr != end; ++itr) {
+      sum += *itr;
+    }
+    ASSERT_EQ(sum, 4 + 5 + 6);
+  }
+}
+
+TEST(StreamLeafIteratorIteratorTest, SingleBlock) {
+  // The previous block is released before the next one is read
+  std::istringstream stream("2 1 2 0 1 3 2 4 5");
+  using Iterator = StreamLeafIteratorIterator<Reader, C::iterator>;
+  Record::peak = Record::live;
+  const auto live = Record::live;
+  auto itr = Iterator(Reader(&stream, 4), Reader());
+  const auto end = Iterator(Reader(), Reader());
+  C c;
+  for (; itr != end; ++itr) {
+    c.push_back(*itr);
+  }
+  ASSERT_EQ(c, C({1, 2, 3, 4, 5}));
+  ASSERT_EQ(Record::peak, live + 2);
+}
+
+}  // namespace algorithm
+}  // namespace takram
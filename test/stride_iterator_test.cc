@@ -0,0 +1,114 @@
+//
+//  stride_iterator_test.cc
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "takram/algorithm/stride_iterator.h"
+
+namespace takram {
+namespace algorithm {
+
+namespace {
+
+struct Vertex {
+  float position[3];
+  unsigned char color[4];
+  float coord[2];
+};
+
+}  // namespace
+
+TEST(StrideIteratorTest, Traversing) {
+  std::vector<Vertex> vertices(5);
+  for (int i{}; i < vertices.size(); ++i) {
+    vertices[i].position[1] = i;
+    vertices[i].color[2] = i * 2;
+  }
+  using Iterator = StrideIterator<float>;
+  auto itr = Iterator(&vertices.front().position[1], sizeof(Vertex));
+  const auto end = itr + vertices.size();
+  ASSERT_EQ(std::distance(itr, end), vertices.size());
+  ASSERT_EQ(end - itr, vertices.size());
+  ASSERT_LT(itr, end);
+  int j{};
+  for (; itr != end; ++itr) {
+    ASSERT_EQ(*itr, j++);
+    *itr = -*itr;
+  }
+  ASSERT_EQ(vertices[3].position[1], -3);
+  ASSERT_EQ(itr[-2], -3);
+  ASSERT_EQ(*--itr, -4);
+
+  using ConstIterator = StrideIterator<const unsigned char>;
+  const auto& constant = vertices;
+  auto first = ConstIterator(&constant.front().color[2], sizeof(Vertex));
+  auto last = first + constant.size();
+  ASSERT_EQ(*std::max_element(first, last), 8);
+  std::vector<unsigned char> reversed(first, last);
+  std::reverse(reversed.begin(), reversed.end());
+  ASSERT_TRUE(std::equal(reversed.begin(), reversed.end(),
+                         std::reverse_iterator<ConstIterator>(last)));
+}
+
+TEST(StrideIteratorTest, Sorting) {
+  std::vector<Vertex> vertices(100);
+  for (int i{}; i < vertices.size(); ++i) {
+    vertices[i].coord[0] = (i * 37) % vertices.size();
+  }
+  using Iterator = StrideIterator<float>;
+  auto begin = Iterator(&vertices.front().coord[0], sizeof(Vertex));
+  auto end = begin + vertices.size();
+  std::sort(begin, end);
+  ASSERT_TRUE(std::is_sorted(begin, end));
+  ASSERT_EQ(vertices.front().coord[0], 0);
+  ASSERT_EQ(vertices.back().coord[0], vertices.size() - 1);
+}
+
+TEST(StrideIteratorTest, DefaultConstructed) {
+  using Iterator = StrideIterator<float>;
+  ASSERT_EQ(Iterator(), Iterator());
+  ASSERT_EQ(Iterator() - Iterator(), 0);
+}
+
+TEST(StrideIteratorTest, Misaligned) {
+  std::vector<Vertex> vertices(2);
+  const auto data = reinterpret_cast<unsigned char *>(vertices.data());
+  EXPECT_DEBUG_DEATH({
+    StrideIterator<float>(reinterpret_cast<float *>(data + 1),
+                          sizeof(Vertex));
+  }, "");
+  EXPECT_DEBUG_DEATH({
+    StrideIterator<float>(&vertices.front().coord[0], sizeof(Vertex) + 1);
+  }, "");
+}
+
+}  // namespace algorithm
+}  // namespace takram
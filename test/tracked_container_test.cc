@@ -0,0 +1,121 @@
+//
+//  tracked_container_test.cc
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#include <iterator>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "takram/algorithm/tracked_container.h"
+
+namespace takram {
+namespace algorithm {
+
+namespace {
+
+using C = std::vector<int>;
+using B = std::vector<C>;
+using A = std::vector<B>;
+
+template <class Iterator>
+C collect(std::pair<Iterator, Iterator> range) {
+  return C(range.first, range.second);
+}
+
+}  // namespace
+
+TEST(TrackedContainerTest, Traversing) {
+  int i{};
+  TrackedContainer<A> a(A{
+      {{++i, ++i}, {++i}}, {{}}, {{++i}, {}, {++i, ++i}}});
+  auto leaves = a.dirty_leaves<B::const_iterator, C::const_iterator>(0);
+  ASSERT_EQ(collect(leaves), C({1, 2, 3, 4, 5, 6}));
+  auto epoch = a.advance();
+  leaves = a.dirty_leaves<B::const_iterator, C::const_iterator>(epoch);
+  ASSERT_EQ(leaves.first, leaves.second);
+  ASSERT_EQ(std::distance(a.dirty_begin(epoch), a.dirty_end()), 0);
+
+  // Modifications of the same subtree are visited once
+  a.modify(2).front().front() = 7;
+  a.modify(0).back().push_back(8);
+  a.modify(2).back().back() = 9;
+  ASSERT_TRUE(a.modified(0, epoch));
+  ASSERT_FALSE(a.modified(1, epoch));
+  ASSERT_TRUE(a.modified(2, epoch));
+  leaves = a.dirty_leaves<B::const_iterator, C::const_iterator>(epoch);
+  ASSERT_EQ(collect(leaves), C({7, 5, 9, 1, 2, 3, 8}));
+  ASSERT_EQ(std::distance(a.dirty_begin(epoch), a.dirty_end()), 2);
+
+  // Older epochs still see everything modified since then
+  const auto previous = epoch;
+  epoch = a.advance();
+  a.modify(1).front().push_back(10);
+  leaves = a.dirty_leaves<B::const_iterator, C::const_iterator>(epoch);
+  ASSERT_EQ(collect(leaves), C({10}));
+  leaves = a.dirty_leaves<B::const_iterator, C::const_iterator>(previous);
+  ASSERT_EQ(collect(leaves), C({7, 5, 9, 1, 2, 3, 8, 10}));
+  leaves = a.dirty_leaves<B::const_iterator, C::const_iterator>(0);
+  ASSERT_EQ(collect(leaves), C({7, 5, 9, 1, 2, 3, 8, 10}));
+}
+
+TEST(TrackedContainerTest, Resizing) {
+  TrackedContainer<B> b;
+  b.push_back(C{1});
+  b.push_back(C{2});
+  auto epoch = b.advance();
+  b.push_back(C{3});
+  ASSERT_EQ(collect(b.dirty_leaves<C::const_iterator>(epoch)), C({3}));
+  ASSERT_EQ(collect(b.dirty_leaves<C::const_iterator>(0)), C({1, 2, 3}));
+
+  // Removed subtrees are not visited, even after growing again
+  b.modify(1).front() = 4;
+  b.resize(1);
+  ASSERT_EQ(collect(b.dirty_leaves<C::const_iterator>(epoch)), C());
+  b.resize(2);
+  b.modify(1).push_back(5);
+  ASSERT_EQ(collect(b.dirty_leaves<C::const_iterator>(epoch)), C({5}));
+  ASSERT_EQ(b.size(), 2);
+}
+
+TEST(TrackedContainerTest, Clearing) {
+  TrackedContainer<B> b(B{{1}, {2}, {3}});
+  auto epoch = b.advance();
+  b.modify(0).front() = 4;
+  epoch = b.advance();
+  b.modify(2).front() = 5;
+  b.clear(epoch);
+  ASSERT_EQ(collect(b.dirty_leaves<C::const_iterator>(0)), C({5}));
+  ASSERT_EQ(collect(b.dirty_leaves<C::const_iterator>(epoch)), C({5}));
+
+  // Subtrees modified again after clearing are recorded again
+  b.modify(0).front() = 6;
+  ASSERT_EQ(collect(b.dirty_leaves<C::const_iterator>(epoch)), C({5, 6}));
+  b.clear(b.advance());
+  ASSERT_EQ(collect(b.dirty_leaves<C::const_iterator>(0)), C());
+}
+
+}  // namespace algorithm
+}  // namespace takram
@@ -27,6 +27,7 @@
 #include <iterator>
 #include <list>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -110,5 +111,48 @@ TEST(TupleIteratorIteratorTest, Distance) {
   }
 }
 
+TEST(TupleIteratorIteratorTest, RandomAccess) {
+  using Iterator = TupleIteratorIterator<A::iterator, C::iterator>;
+  static_assert(std::is_same<
+      std::iterator_traits<Iterator>::iterator_category,
+      std::random_access_iterator_tag>::value, "");
+  static_assert(std::is_same<
+      std::iterator_traits<TupleIteratorIterator<A::iterator, B::iterator>>
+          ::iterator_category,
+      std::forward_iterator_tag>::value, "");
+  A a(10);
+  C c(8);
+  std::iota(a.begin(), a.end(), 0);
+  for (int i = 0; i < c.size(); ++i) {
+    c.at(i).value = i;
+  }
+  const auto begin = Iterator(std::begin(a), std::begin(c));
+  const auto end = Iterator(std::end(a), std::end(c));
+  ASSERT_EQ(end - begin, 8);
+  ASSERT_EQ(begin - end, -8);
+  ASSERT_EQ(std::distance(begin, end), 8);
+  ASSERT_LT(begin, end);
+  auto itr = begin + 5;
+  ASSERT_EQ(std::get<0>(*itr), 5);
+  ASSERT_EQ(std::get<1>(*itr).value, 5);
+  ASSERT_EQ(std::get<0>(itr[-2]), 3);
+  itr -= 3;
+  ASSERT_EQ(std::get<1>(*--itr).value, 1);
+  ASSERT_EQ(itr - begin, 1);
+  ASSERT_EQ(std::next(begin, 8), end);
+}
+
+TEST(TupleIteratorIteratorTest, Conversion) {
+  using ConstIterator = TupleIteratorIterator<A::const_iterator,
+                                              B::const_iterator>;
+  A a{1, 2};
+  B b{3, 4};
+  const auto itr = TupleIteratorIterator<A::iterator, B::iterator>(
+      std::begin(a), std::begin(b));
+  ConstIterator converted(itr);
+  ASSERT_EQ(converted, ConstIterator(a.cbegin(), b.cbegin()));
+  ASSERT_EQ(std::get<1>(*++converted), 4);
+}
+
 }  // namespace algorithm
 }  // namespace takram
@@ -0,0 +1,116 @@
+//
+//  zip_leaf_iterator_iterator_test.cc
+//
+//  The MIT License
+//
+//  Copyright (C) 2015 Shota Matsuda
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a
+//  copy of this software and associated documentation files (the "Software"),
+//  to deal in the Software without restriction, including without limitation
+//  the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//  and/or sell copies of the Software, and to permit persons to whom the
+//  Software is furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+//  THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+//  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//  DEALINGS IN THE SOFTWARE.
+//
+
+#include <iterator>
+#include <list>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "takram/algorithm/tuple_iterator_iterator.h"
+#include "takram/algorithm/zip_leaf_iterator_iterator.h"
+
+namespace takram {
+namespace algorithm {
+
+namespace {
+
+using C = std::vector<int>;
+using B = std::vector<C>;
+using A = std::vector<B>;
+using F = std::list<float>;
+using E = std::vector<F>;
+using D = std::vector<E>;
+using Iterator = ZipLeafIteratorIterator<
+    TupleIteratorIterator<A::iterator, D::iterator>,
+    TupleIteratorIterator<B::iterator, E::iterator>,
+    TupleIteratorIterator<C::iterator, F::iterator>>;
+using EnumeratedIterator = EnumeratedZipLeafIteratorIterator<
+    TupleIteratorIterator<A::iterator, D::iterator>,
+    TupleIteratorIterator<B::iterator, E::iterator>,
+    TupleIteratorIterator<C::iterator, F::iterator>>;
+using Outer = TupleIteratorIterator<A::iterator, D::iterator>;
+
+}  // namespace
+
+TEST(ZipLeafIteratorIteratorTest, Traversing) {
+  {
+    A a;
+    D d;
+    auto itr = Iterator(Outer(std::begin(a), std::begin(d)),
+                        Outer(std::end(a), std::end(d)));
+    const auto end = Iterator(Outer(std::end(a), std::end(d)),
+                              Outer(std::end(a), std::end(d)));
+    ASSERT_EQ(itr, end);
+  } {
+    int i{};
+    A a{{}, {{}, {++i, ++i}, {}}, {{++i}}, {{}, {++i, ++i}}};
+    D d{{}, {{}, {1, 2}, {}}, {{3}}, {{}, {4, 5}}};
+    auto itr = Iterator(Outer(std::begin(a), std::begin(d)),
+                        Outer(std::end(a), std::end(d)));
+    const auto end = Iterator(Outer(std::end(a), std::end(d)),
+                              Outer(std::end(a), std::end(d)));
+    ASSERT_NE(itr, end);
+    int j{};
+    for (; itr != end; ++itr) {
+      auto& a = std::get<0>(*itr);
+      auto& d = std::get<1>(*itr);
+      ASSERT_EQ(a, ++j);
+      ASSERT_EQ(d, j);
+      d = -d;
+    }
+    ASSERT_EQ(itr, end);
+    ASSERT_EQ(j, i);
+    ASSERT_EQ(d.at(3).at(1).back(), -5);
+  }
+}
+
+TEST(ZipLeafIteratorIteratorTest, Path) {
+  A a{{}, {{}, {1, 2}, {}}, {{3}}, {{}, {4, 5}}};
+  D d{{}, {{}, {1, 2}, {}}, {{3}}, {{}, {4, 5}}};
+  auto itr = EnumeratedIterator(Outer(std::begin(a), std::begin(d)),
+                                Outer(std::end(a), std::end(d)), {{3, 1, 0}});
+  const auto end = EnumeratedIterator(Outer(std::end(a), std::end(d)),
+                                      Outer(std::end(a), std::end(d)));
+  ASSERT_EQ(std::get<0>(*itr), 4);
+  ASSERT_EQ(std::get<1>(*itr), 4);
+  ASSERT_EQ(itr.path(), EnumeratedIterator::Path({{3, 1, 0}}));
+  ASSERT_EQ(std::distance(itr, end), 2);
+}
+
+TEST(ZipLeafIteratorIteratorTest, Mismatch) {
+  A a{{{1, 2}}};
+  D d{{{1}}};
+  EXPECT_DEBUG_DEATH({
+    auto itr = Iterator(Outer(std::begin(a), std::begin(d)),
+                        Outer(std::end(a), std::end(d)));
+    ++itr;
+  }, "");
+}
+
+}  // namespace algorithm
+}  // namespace takram